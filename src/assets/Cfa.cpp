@@ -9,7 +9,8 @@
 // Constructors
 //******************************************************************************
 Cfa::Cfa(const QVector<char> &data, Palette palette) : mPalette(std::move(palette)) {
-    QDataStream stream = QDataStream(QByteArray((data.constData()), data.size()));
+    // Reading the data in place, it outlives the stream
+    QDataStream stream = QDataStream(QByteArray::fromRawData(data.constData(), data.size()));
     initFromStreamAndPalette(stream, data.size());
 }
 
@@ -82,39 +83,41 @@ void Cfa::initFromStreamAndPalette(QDataStream &dataStream, const quint16 &dataS
         quint16 colorTableSize(totalHeaderSize - 76);
         QVector<char> colorTableRealIndexes(colorTableSize);
         dataStream.readRawData(colorTableRealIndexes.data(), colorTableSize);
-        // reading frames
+        // reading frames, through buffers shared by all the frames
         quint8 leftOverBits = NB_BITS_IN_BYTE - bitsPerPixel;
+        QVector<char> compressedFrameData;
+        QVector<char> frameData(compressedWidth * mHeight);
         for (int frameIndex = 0; frameIndex < frameNumber; ++frameIndex) {
             // reading and uncompressing frame data
             quint16 compressedFrameDataSize = frameDataOffsets[frameIndex + 1] - frameDataOffsets[frameIndex];
             StreamUtils::verifyStream(dataStream, compressedFrameDataSize);
-            QVector<char> compressedFrameData(compressedFrameDataSize);
+            compressedFrameData.resize(compressedFrameDataSize);
             dataStream.readRawData(compressedFrameData.data(), compressedFrameDataSize);
-            // RLE uncompression
-            const QVector<char> frameData = Compression::uncompressRLE(compressedFrameData, compressedWidth * mHeight);
-            QVector<char> frame;
+            // RLE uncompression, on a single line
+            Compression::decode(0x02, DataView(compressedFrameData), frameData.data(), compressedWidth * mHeight, 1);
+            QVector<char> frame(mWidth * mHeight);
+            char *pixels = frame.data();
             // Bits expansion for each line of pixels
             for (int lineIndex = 0; lineIndex < mHeight; ++lineIndex) {
-                deque<char> compressedLine(compressedWidth);
-                QVector<char>::const_iterator start = frameData.begin() + compressedWidth * lineIndex;
-                std::copy(start, start + compressedWidth, compressedLine.begin());
-                BitsReader bitsReader(compressedLine);
+                // reading the line in place
+                const char *start = frameData.constData() + compressedWidth * lineIndex;
+                BitsReader bitsReader(start, start + compressedWidth);
                 for (int pixelIndex = 0; pixelIndex < mWidth; ++pixelIndex) {
                     quint8 pixel = bitsReader.getBits() >> leftOverBits;
                     bitsReader.removeBits(bitsPerPixel);
                     // if no color table (8 bits per pixel for example -> direct original pixel value)
                     if (colorTableSize == 0) {
-                        frame.push_back(char(pixel));
+                        *pixels++ = char(pixel);
                     }
                     else {
                         if (pixel >= colorTableRealIndexes.size()) {
                             throw Status(-1, QStringLiteral("pixel outside color table"));
                         }
-                        frame.push_back(colorTableRealIndexes[pixel]);
+                        *pixels++ = colorTableRealIndexes[pixel];
                     }
                 }
             }
-            mFramesData.push_back(frame);
+            mFramesData.push_back(std::move(frame));
         }
         // verifying frames and building QImages
         for (auto &frame : mFramesData) {
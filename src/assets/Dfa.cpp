@@ -9,7 +9,8 @@ using namespace std;
 // Constructors
 //******************************************************************************
 Dfa::Dfa(const QVector<char> &data, Palette palette) : mPalette(std::move(palette)) {
-    QDataStream stream = QDataStream(QByteArray((data.constData()), data.size()));
+    // Reading the data in place, it outlives the stream
+    QDataStream stream = QDataStream(QByteArray::fromRawData(data.constData(), data.size()));
     initFromStreamAndPalette(stream);
 }
 
@@ -66,7 +67,9 @@ void Dfa::initFromStreamAndPalette(QDataStream &dataStream) {
         QVector<char> firstFrameCompressedData(firstFrameDataSize);
         StreamUtils::verifyStream(dataStream, firstFrameDataSize);
         dataStream.readRawData(firstFrameCompressedData.data(), firstFrameDataSize);
-        const QVector<char> firstFrameData = Compression::uncompressRLE(firstFrameCompressedData, mWidth * mHeight);
+        // RLE uncompression, on a single line
+        QVector<char> firstFrameData(mWidth * mHeight);
+        Compression::decode(0x02, DataView(firstFrameCompressedData), firstFrameData.data(), mWidth * mHeight, 1);
         mFramesData.push_back(firstFrameData);
         // reading other frame
         for (int frameIndex = 1; frameIndex < frameCount; ++frameIndex) {
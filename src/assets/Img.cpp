@@ -2,6 +2,7 @@
 #include <error/Status.h>
 #include <assets/Img.h>
 #include <utils/StreamUtils.h>
+#include <QtEndian>
 
 using namespace std;
 
@@ -9,7 +10,8 @@ using namespace std;
 // Constructors
 //******************************************************************************
 Img::Img(const QVector<char> &imgData, Palette palette) {
-    QDataStream stream = QDataStream(QByteArray((imgData.constData()), imgData.size()));
+    // Reading the data in place, it outlives the stream
+    QDataStream stream = QDataStream(QByteArray::fromRawData(imgData.constData(), imgData.size()));
     initFromStreamAndPalette(stream, std::move(palette));
 }
 
@@ -19,7 +21,7 @@ Img::Img(QDataStream &imgData, Palette palette) {
 
 Img::Img(const QVector<char> &imgData, quint16 width, quint16 height, Palette palette) :
         mWidth(width), mHeight(height), mRawDataSize(width * height) {
-    QDataStream stream = QDataStream(QByteArray((imgData.constData()), imgData.size()));
+    QDataStream stream = QDataStream(QByteArray::fromRawData(imgData.constData(), imgData.size()));
     initFromStreamAndPalette(stream, std::move(palette), true);
 }
 
@@ -28,6 +30,71 @@ Img::Img(QDataStream &imgData, quint16 width, quint16 height, Palette palette) :
     initFromStreamAndPalette(imgData, std::move(palette), true);
 }
 
+//******************************************************************************
+// Statics
+//******************************************************************************
+bool Img::hasMatchingHeader(const QVector<char> &imgData) {
+    if (imgData.size() < HEADER_SIZE) {
+        return false;
+    }
+    quint8 paletteFlag = quint8(imgData.at(9));
+    int expectedSize = HEADER_SIZE + qFromLittleEndian<quint16>(imgData.constData() + 10) +
+                       ((paletteFlag & 1u) ? INTEGRATED_PALETTE_SIZE : 0);
+    return imgData.size() == expectedSize;
+}
+
+QVector<char> Img::recompress(const QVector<char> &imgData) {
+    Img img(imgData);
+    const QVector<char> &pixels = img.mImageData;
+    // Candidates image data, for each compression flag
+    QVector<QPair<quint8, QVector<char>>> candidates;
+    candidates.append(qMakePair(quint8(0x02), Compression::compressRLEByLine(pixels, img.mWidth, img.mHeight)));
+    candidates.append(qMakePair(quint8(0x04), Compression::compressLZSS(pixels)));
+    // Deflate data is prefixed by the uncompressed size on 2 bytes
+    if (pixels.size() <= 0xFFFF) {
+        QVector<char> deflateData(2);
+        qToLittleEndian(quint16(pixels.size()), deflateData.data());
+        deflateData.append(Compression::compressDeflate(pixels));
+        candidates.append(qMakePair(quint8(0x08), deflateData));
+    }
+    std::stable_sort(candidates.begin(), candidates.end(), [](const auto &first, const auto &second) {
+        return first.second.size() < second.second.size();
+    });
+    // Candidates are decoded back in the same buffer
+    QVector<char> uncompressedData(pixels.size());
+    for (const auto &candidate : qAsConst(candidates)) {
+        const QVector<char> &data = candidate.second;
+        // Image data size is stored on 2 bytes, and the image should get smaller
+        if (data.size() > 0xFFFF || data.size() >= img.mRawDataSize) {
+            break;
+        }
+        // Deflate data is decoded after the uncompressed size
+        const int sizePrefix = candidate.first == 0x08 ? 2 : 0;
+        try {
+            const qint64 uncompressedSize = Compression::decode(
+                    candidate.first, DataView(data.constData() + sizePrefix, data.size() - sizePrefix),
+                    uncompressedData.data(), img.mWidth, img.mHeight);
+            if (uncompressedSize != pixels.size()) {
+                continue;
+            }
+        } catch (Status &) {
+            continue;
+        }
+        if (uncompressedData != pixels) {
+            continue;
+        }
+        QVector<char> recompressedData;
+        recompressedData.reserve(imgData.size() - img.mRawDataSize + data.size());
+        recompressedData.append(imgData.mid(0, HEADER_SIZE));
+        recompressedData[8] = char(candidate.first);
+        qToLittleEndian(quint16(data.size()), recompressedData.data() + 10);
+        recompressedData.append(data);
+        recompressedData.append(imgData.mid(HEADER_SIZE + img.mRawDataSize));
+        return recompressedData;
+    }
+    return imgData;
+}
+
 //******************************************************************************
 // Methods
 //******************************************************************************
@@ -102,29 +169,33 @@ void Img::initFromStreamAndPalette(QDataStream &imgDataStream, Palette palette,
             imgDataStream >> mRawDataSize;
         }
         StreamUtils::verifyStream(imgDataStream, mRawDataSize);
-        QVector<char> rawData(mCompressionFlag == 0x08 ? mRawDataSize - 2 : mRawDataSize);
         if (mCompressionFlag == 0x00) {
-            StreamUtils::readDataFromStream(imgDataStream, rawData, mRawDataSize);
-            mImageData = rawData;
-            validatePixelDataAndCreateImage();
-        } else if (mCompressionFlag == 0x02) {
-            StreamUtils::readDataFromStream(imgDataStream, rawData, mRawDataSize);
-            mImageData = Compression::uncompressRLEByLine(rawData, mWidth, mHeight);
-            validatePixelDataAndCreateImage();
-        } else if (mCompressionFlag == 0x04) {
-            StreamUtils::readDataFromStream(imgDataStream, rawData, mRawDataSize);
-            mImageData = Compression::uncompressLZSS(rawData);
-            validatePixelDataAndCreateImage();
-        } else if (mCompressionFlag == 0x08) {
-            quint16 uncompressedSize = 0;
-            imgDataStream >> uncompressedSize;
-            StreamUtils::readDataFromStream(imgDataStream, rawData, mRawDataSize - 2);
-            mImageData = Compression::uncompressDeflate(rawData, uncompressedSize);
-            validatePixelDataAndCreateImage();
+            mImageData.resize(mRawDataSize);
+            StreamUtils::readDataFromStream(imgDataStream, mImageData, mRawDataSize);
+        } else if (mCompressionFlag == 0x02 || mCompressionFlag == 0x04 || mCompressionFlag == 0x08) {
+            quint16 compressedSize = mRawDataSize;
+            if (mCompressionFlag == 0x08) {
+                if (mRawDataSize < 2) {
+                    throw Status(-1, QStringLiteral("Data is too short or not readable"));
+                }
+                quint16 uncompressedSize = 0;
+                imgDataStream >> uncompressedSize;
+                if (uncompressedSize != mWidth * mHeight) {
+                    throw Status(-1, "This image contained too much or too few pixels for its size");
+                }
+                compressedSize -= 2;
+            }
+            QVector<char> rawData(compressedSize);
+            StreamUtils::readDataFromStream(imgDataStream, rawData, compressedSize);
+            // Uncompressing straight into the pixels backing the image
+            mImageData.resize(mWidth * mHeight);
+            mImageData.resize(int(Compression::decode(mCompressionFlag, DataView(rawData), mImageData.data(), mWidth,
+                                                      mHeight)));
         } else {
             throw Status(-1, QStringLiteral("This image compression is not supported : ") +
                              QString::number(mCompressionFlag));
         }
+        validatePixelDataAndCreateImage();
     }
     catch (Status &e) {
         throw Status(-1, "Unable to load img data : " + e.message());
@@ -20,6 +20,38 @@
 class Img
 {
 public:
+    //**************************************************************************
+    // Statics
+    //**************************************************************************
+    /**
+     * @brief size of the IMG header
+     */
+    const static int HEADER_SIZE = 12;
+
+    /**
+     * @brief size of an integrated palette
+     */
+    const static int INTEGRATED_PALETTE_SIZE = 768;
+
+    /**
+     * @brief check if the data starts with a header describing exactly the data: the header, the image data and the
+     * integrated palette if any. Raw pixels of an IMG without header seldom do
+     * @param imgData data of the IMG file
+     * @return true if the data size matches its header
+     */
+    static bool hasMatchingHeader(const QVector<char> &imgData);
+
+    /**
+     * @brief re-encode the image data of an IMG with the compression giving the smallest file among RLE by line
+     * (0x02), LZSS (0x04) and deflate (0x08). Each candidate is checked by uncompressing it before being kept. The
+     * compression flag and the image data size of the header are rewritten to match, the data following the image
+     * (palette) is kept as is
+     * @param imgData data of the IMG file, with header
+     * @return the smallest version of the IMG, imgData itself if no compression makes it smaller
+     * @throw Status if the img could not be loaded
+     */
+    static QVector<char> recompress(const QVector<char> &imgData);
+
     //**************************************************************************
     // Constructors
     //**************************************************************************
@@ -0,0 +1,146 @@
+#include <bsa/ArchiveDiff.h>
+#include <bsa/ArchiveIndex.h>
+#include <utils/FileUtils.h>
+#include <QDir>
+
+//******************************************************************************
+// Statics
+//******************************************************************************
+const QString ArchiveDiff::PATCH_MANIFEST_NAME("PATCH.MANIFEST"); // NOLINT(cert-err58-cpp)
+
+//******************************************************************************
+// Getters/setters
+//******************************************************************************
+const QVector<BsaFile> &ArchiveDiff::addedFiles() const {
+    return mAddedFiles;
+}
+
+const QVector<BsaFile> &ArchiveDiff::removedFiles() const {
+    return mRemovedFiles;
+}
+
+const QVector<BsaFile> &ArchiveDiff::changedFiles() const {
+    return mChangedFiles;
+}
+
+bool ArchiveDiff::isEmpty() const {
+    return mAddedFiles.isEmpty() && mRemovedFiles.isEmpty() && mChangedFiles.isEmpty();
+}
+
+//******************************************************************************
+// Methods
+//******************************************************************************
+void ArchiveDiff::exportPatch(BsaArchive &newArchive, const QString &patchFolder) const {
+    QVector<BsaFile> patchFiles = mAddedFiles + mChangedFiles;
+    QVector<Status> results = newArchive.extractFiles(patchFolder, patchFiles);
+    for (int i(0); i < results.size(); i++) {
+        if (results.at(i).code() != 0) {
+            throw Status(-1, QString("Unable to export the patch : %1").arg(results.at(i).message()));
+        }
+    }
+    // One operation by line: A for added, C for changed, D for deleted, followed by the file name
+    QByteArray manifest;
+    for (const auto &file : mAddedFiles) {
+        manifest += "A " + file.fileName().toLatin1() + '\n';
+    }
+    for (const auto &file : mChangedFiles) {
+        manifest += "C " + file.fileName().toLatin1() + '\n';
+    }
+    for (const auto &file : mRemovedFiles) {
+        manifest += "D " + file.fileName().toLatin1() + '\n';
+    }
+    FileUtils::writeDataToFile(patchFolder + QDir::separator() + PATCH_MANIFEST_NAME,
+                               manifest.constData(), manifest.size());
+}
+
+//******************************************************************************
+// Static Methods
+//******************************************************************************
+ArchiveDiff ArchiveDiff::compare(BsaArchive &oldArchive, BsaArchive &newArchive) {
+    if (!oldArchive.isOpened() || !newArchive.isOpened()) {
+        throw Status(-1, QStringLiteral("Cannot compare archives: not opened"));
+    }
+    ArchiveDiff diff;
+    const QVector<BsaFile> &oldFiles = oldArchive.files();
+    const QVector<BsaFile> &newFiles = newArchive.files();
+    // Walking both sorted lists at once, keeping the files of the same name and size to hash
+    QVector<BsaFile> oldCandidates;
+    QVector<BsaFile> newCandidates;
+    int oldIdx(0), newIdx(0);
+    while (oldIdx < oldFiles.size() || newIdx < newFiles.size()) {
+        if (newIdx == newFiles.size() || (oldIdx < oldFiles.size() && oldFiles.at(oldIdx) < newFiles.at(newIdx))) {
+            diff.mRemovedFiles.append(oldFiles.at(oldIdx++));
+        } else if (oldIdx == oldFiles.size() || newFiles.at(newIdx) < oldFiles.at(oldIdx)) {
+            diff.mAddedFiles.append(newFiles.at(newIdx++));
+        } else {
+            const BsaFile &oldFile = oldFiles.at(oldIdx++);
+            const BsaFile &newFile = newFiles.at(newIdx++);
+            quint32 oldSize = oldFile.dataSize();
+            quint32 newSize = newFile.dataSize();
+            if (oldSize != newSize) {
+                diff.mChangedFiles.append(newFile);
+            } else {
+                oldCandidates.append(oldFile);
+                newCandidates.append(newFile);
+            }
+        }
+    }
+    // Comparing the data of the files of the same size
+    ArchiveIndex oldIndex(oldArchive);
+    ArchiveIndex newIndex(newArchive);
+    QVector<quint64> oldHashes = oldIndex.getHashes(oldCandidates);
+    QVector<quint64> newHashes = newIndex.getHashes(newCandidates);
+    for (int i(0); i < newCandidates.size(); i++) {
+        if (oldHashes.at(i) != newHashes.at(i)) {
+            diff.mChangedFiles.append(newCandidates.at(i));
+        }
+    }
+    sort(diff.mChangedFiles.begin(), diff.mChangedFiles.end());
+    return diff;
+}
+
+void ArchiveDiff::applyPatch(BsaArchive &archive, const QString &patchFolder) {
+    QDir folder(patchFolder);
+    QByteArray manifest = FileUtils::readDataFromFile(folder.filePath(PATCH_MANIFEST_NAME));
+    QStringList patchFilePaths;
+    QVector<BsaFile> removedFiles;
+    for (const QByteArray &line : manifest.split('\n')) {
+        if (line.isEmpty()) {
+            continue;
+        }
+        if (line.size() < 3 || line.at(1) != ' ') {
+            throw Status(-1, QString("Invalid patch manifest line : %1").arg(QString::fromLatin1(line)));
+        }
+        QString fileName = QString::fromLatin1(line.mid(2));
+        switch (line.at(0)) {
+            case 'A':
+                if (archive.getFile(fileName).isValid()) {
+                    throw Status(-1, QString("The patch does not match the archive: %1 is already in it")
+                            .arg(fileName));
+                }
+                patchFilePaths.append(folder.filePath(fileName));
+                break;
+            case 'C':
+                if (!archive.getFile(fileName).isValid()) {
+                    throw Status(-1, QString("The patch does not match the archive: %1 is not in it").arg(fileName));
+                }
+                patchFilePaths.append(folder.filePath(fileName));
+                break;
+            case 'D': {
+                BsaFile removedFile = archive.getFile(fileName);
+                if (!removedFile.isValid()) {
+                    throw Status(-1, QString("The patch does not match the archive: %1 is not in it").arg(fileName));
+                }
+                removedFiles.append(removedFile);
+                break;
+            }
+            default:
+                throw Status(-1, QString("Invalid patch manifest line : %1").arg(QString::fromLatin1(line)));
+        }
+    }
+    // All the patch files are checked before any change
+    archive.addOrUpdateFiles(patchFilePaths);
+    for (const auto &file : removedFiles) {
+        archive.deleteFile(file);
+    }
+}
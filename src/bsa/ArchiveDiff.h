@@ -0,0 +1,102 @@
+#ifndef BSATOOL_ARCHIVEDIFF_H
+#define BSATOOL_ARCHIVEDIFF_H
+
+#include <bsa/BsaArchive.h>
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief Differences between two versions of an archive
+ *
+ * Files are matched by name. Files of the same name are compared by size first, then by the hash of their data, so
+ * neither archive is extracted. The differences can be exported as a patch: a folder holding the added and changed
+ * files and a manifest listing the operations, which can be applied to the old version of the archive
+ */
+class ArchiveDiff {
+public:
+    //**************************************************************************
+    // Statics
+    //**************************************************************************
+    /**
+     * @brief name of the patch manifest. Longer than 13 characters so that it never matches an archive file
+     */
+    const static QString PATCH_MANIFEST_NAME;
+
+    //**************************************************************************
+    // Getters/setters
+    //**************************************************************************
+    /**
+     * @brief files of the new archive not in the old one
+     */
+    [[nodiscard]]const QVector<BsaFile> &addedFiles() const;
+    /**
+     * @brief files of the old archive not in the new one
+     */
+    [[nodiscard]]const QVector<BsaFile> &removedFiles() const;
+    /**
+     * @brief files of the new archive whose data differs from the old one
+     */
+    [[nodiscard]]const QVector<BsaFile> &changedFiles() const;
+    /**
+     * @brief true if the archives have the same files with the same data
+     */
+    [[nodiscard]]bool isEmpty() const;
+
+    //**************************************************************************
+    // Methods
+    //**************************************************************************
+    /**
+     * @brief export the differences as a patch: the added and changed files are extracted from the new archive to the
+     * patch folder, along with the patch manifest
+     * @param newArchive the new archive compared
+     * @param patchFolder existing folder receiving the patch
+     * @throw Status if a file cannot be extracted or the manifest cannot be written
+     */
+    void exportPatch(BsaArchive &newArchive, const QString &patchFolder) const;
+
+    //**************************************************************************
+    // Static Methods
+    //**************************************************************************
+    /**
+     * @brief compare two versions of an archive. Files are hashed concurrently on the global thread pool
+     * @param oldArchive the old version of the archive
+     * @param newArchive the new version of the archive
+     * @return the differences from the old version to the new one
+     * @throw Status if an archive is not opened or a file is unreadable
+     */
+    static ArchiveDiff compare(BsaArchive &oldArchive, BsaArchive &newArchive);
+
+    /**
+     * @brief apply a patch to an archive: the patch files are added or updated in one batch, then the removed files
+     * are deleted. The archive is left untouched if the patch does not match it
+     * @param archive the archive to patch, opened
+     * @param patchFolder folder containing the patch
+     * @throw Status if the manifest is unreadable or invalid, a patch file is missing, an added file is already in the
+     * archive or a changed or removed file is not in the archive
+     */
+    static void applyPatch(BsaArchive &archive, const QString &patchFolder);
+
+private:
+    //**************************************************************************
+    // Constructors
+    //**************************************************************************
+    ArchiveDiff() = default;
+
+    //**************************************************************************
+    // Attributes
+    //**************************************************************************
+    /**
+     * @brief files of the new archive not in the old one
+     */
+    QVector<BsaFile> mAddedFiles{};
+    /**
+     * @brief files of the old archive not in the new one
+     */
+    QVector<BsaFile> mRemovedFiles{};
+    /**
+     * @brief files of the new archive whose data differs from the old one
+     */
+    QVector<BsaFile> mChangedFiles{};
+};
+
+#endif // BSATOOL_ARCHIVEDIFF_H
@@ -0,0 +1,160 @@
+#include <bsa/ArchiveIndex.h>
+#include <utils/HashUtils.h>
+#include <utils/ConcurrentUtils.h>
+#include <numeric>
+
+//**************************************************************************
+// Constructors
+//**************************************************************************
+ArchiveIndex::ArchiveIndex(BsaArchive &archive, QObject *parent) : QObject(parent), mArchive(archive) {
+    // A reopened archive may have been changed by another program
+    connect(&mArchive, &BsaArchive::archiveOpened, this, &ArchiveIndex::clearCache);
+    // fileListModified is also sent on save and close, where the files offsets change
+    connect(&mArchive, &BsaArchive::fileListModified, this, &ArchiveIndex::dropChangedHashes);
+    connect(&mArchive, &BsaArchive::fileListChanged, this, &ArchiveIndex::dropChangedHashes);
+}
+
+//**************************************************************************
+// Getters/setters
+//**************************************************************************
+int ArchiveIndex::cachedHashNumber() const {
+    return mHashCache.size();
+}
+
+//**************************************************************************
+// Methods
+//**************************************************************************
+quint64 ArchiveIndex::getHash(const BsaFile &file) {
+    return getHashes({file}).first();
+}
+
+QVector<quint64> ArchiveIndex::getHashes(const QVector<BsaFile> &files) {
+    // Using the archive version of the files to know their state
+    QVector<BsaFile> internFiles;
+    internFiles.reserve(files.size());
+    for (const auto &file : files) {
+        BsaFile internFile = mArchive.getFile(file.fileName());
+        if (!internFile.isValid()) {
+            throw Status(-1, QString("The file %1 is not in the archive").arg(file.fileName()));
+        }
+        internFiles.append(internFile);
+    }
+    QVector<quint64> hashes(files.size(), 0);
+    QVector<int> missingIndexes;
+    for (int i(0); i < internFiles.size(); i++) {
+        const BsaFile &file = internFiles.at(i);
+        auto cached = mHashCache.constFind(file.fileName());
+        if (!file.isNew() && !file.updated() && cached != mHashCache.constEnd() &&
+            cached->offset == file.startOffsetInArchive() && cached->size == file.size()) {
+            hashes[i] = cached->hash;
+        } else {
+            missingIndexes.append(i);
+        }
+    }
+    QVector<quint64> computedHashes = ConcurrentUtils::blockingMapped<quint64>(
+            missingIndexes, [&](int index) { return computeHash(internFiles.at(index)); },
+            [&](int index) { return internFiles.at(index).fileName(); }, QStringLiteral("Unable to hash files data"));
+    for (int i(0); i < missingIndexes.size(); i++) {
+        const BsaFile &file = internFiles.at(missingIndexes.at(i));
+        hashes[missingIndexes.at(i)] = computedHashes.at(i);
+        if (!file.isNew() && !file.updated()) {
+            mHashCache.insert(file.fileName(), {file.startOffsetInArchive(), file.size(), computedHashes.at(i)});
+        }
+    }
+    return hashes;
+}
+
+QVector<QVector<BsaFile>> ArchiveIndex::getDuplicateGroups() {
+    const QVector<BsaFile> files = mArchive.getFiles();
+    // Only files with the same size can be identical
+    QVector<int> sizeOrder(files.size());
+    iota(sizeOrder.begin(), sizeOrder.end(), 0);
+    stable_sort(sizeOrder.begin(), sizeOrder.end(), [&files](int first, int second) {
+        return files.at(first).dataSize() < files.at(second).dataSize();
+    });
+    QVector<int> candidates;
+    for (int i(0); i < sizeOrder.size(); i++) {
+        qint64 size = files.at(sizeOrder.at(i)).dataSize();
+        bool sharedSize = (i > 0 && files.at(sizeOrder.at(i - 1)).dataSize() == size) ||
+                          (i + 1 < sizeOrder.size() && files.at(sizeOrder.at(i + 1)).dataSize() == size);
+        if (sharedSize) {
+            candidates.append(sizeOrder.at(i));
+        }
+    }
+    // Grouping the candidates by size and hash, keeping the name order in each group
+    QVector<BsaFile> candidateFiles;
+    candidateFiles.reserve(candidates.size());
+    for (int idx : qAsConst(candidates)) {
+        candidateFiles.append(files.at(idx));
+    }
+    QVector<quint64> hashes = getHashes(candidateFiles);
+    QVector<int> hashOrder(candidates.size());
+    iota(hashOrder.begin(), hashOrder.end(), 0);
+    auto sameContent = [&](int first, int second) {
+        return candidateFiles.at(first).dataSize() == candidateFiles.at(second).dataSize() &&
+               hashes.at(first) == hashes.at(second);
+    };
+    stable_sort(hashOrder.begin(), hashOrder.end(), [&](int first, int second) {
+        qint64 firstSize = candidateFiles.at(first).dataSize();
+        qint64 secondSize = candidateFiles.at(second).dataSize();
+        if (firstSize != secondSize) {
+            return firstSize < secondSize;
+        }
+        if (hashes.at(first) != hashes.at(second)) {
+            return hashes.at(first) < hashes.at(second);
+        }
+        return candidates.at(first) < candidates.at(second);
+    });
+    QVector<QVector<BsaFile>> duplicateGroups;
+    for (int start(0), end(0); start < hashOrder.size(); start = end) {
+        end = start + 1;
+        while (end < hashOrder.size() && sameContent(hashOrder.at(start), hashOrder.at(end))) {
+            end++;
+        }
+        if (end - start > 1) {
+            QVector<BsaFile> group;
+            for (int i(start); i < end; i++) {
+                group.append(candidateFiles.at(hashOrder.at(i)));
+            }
+            duplicateGroups.append(group);
+        }
+    }
+    sort(duplicateGroups.begin(), duplicateGroups.end(),
+         [](const QVector<BsaFile> &first, const QVector<BsaFile> &second) {
+             return first.first() < second.first();
+         });
+    return duplicateGroups;
+}
+
+qint64 ArchiveIndex::getWastedBytes(const QVector<QVector<BsaFile>> &duplicateGroups) {
+    qint64 wastedBytes(0);
+    for (const auto &group : duplicateGroups) {
+        wastedBytes += qint64(group.first().dataSize()) * (group.size() - 1);
+    }
+    return wastedBytes;
+}
+
+void ArchiveIndex::clearCache() {
+    mHashCache.clear();
+}
+
+void ArchiveIndex::dropChangedHashes() {
+    for (auto it = mHashCache.begin(); it != mHashCache.end();) {
+        BsaFile file = mArchive.getFile(it.key());
+        if (!file.isValid() || file.isNew() || file.updated() || file.startOffsetInArchive() != it->offset ||
+            file.size() != it->size) {
+            it = mHashCache.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+quint64 ArchiveIndex::computeHash(const BsaFile &file) {
+    if (mArchive.isMemoryMapped() && !file.isNew() && !file.updated()) {
+        DataView view = mArchive.getFileView(file);
+        return HashUtils::xxHash64(view.data(), view.size());
+    }
+    QVector<char> data = mArchive.getFileData(file);
+    return HashUtils::xxHash64(data.constData(), data.size());
+}
@@ -0,0 +1,124 @@
+#ifndef BSATOOL_ARCHIVEINDEX_H
+#define BSATOOL_ARCHIVEINDEX_H
+
+#include <bsa/BsaArchive.h>
+#include <QHash>
+#include <QObject>
+#include <QVector>
+
+/**
+ * @brief Index of the content of the files of an archive
+ *
+ * Files are identified by a 64 bits xxHash of their data, computed in parallel. The hashes of the files stored in the
+ * archive are cached by name with their offset and size. When the files list changes, only the hashes of the deleted,
+ * updated or moved files are dropped. The whole cache is cleared when an archive is opened. New and updated files are
+ * hashed from their external file each time.
+ *
+ * The BSA format stores the files data one after the other with offsets implied by the sizes, so identical files
+ * cannot share their data: duplicates can only be reported
+ */
+class ArchiveIndex : public QObject {
+    Q_OBJECT
+public:
+    //**************************************************************************
+    // Constructors
+    //**************************************************************************
+    /**
+     * @brief constructor of the index of an archive. The archive must outlive the index
+     * @param archive the indexed archive
+     * @param parent parent object
+     */
+    explicit ArchiveIndex(BsaArchive &archive, QObject *parent = nullptr);
+
+    //**************************************************************************
+    // Getters/setters
+    //**************************************************************************
+    /**
+     * @brief number of archive files whose hash is cached
+     */
+    [[nodiscard]]int cachedHashNumber() const;
+
+    //**************************************************************************
+    // Methods
+    //**************************************************************************
+    /**
+     * @brief retrieve the hash of a file data
+     * @param file the file
+     * @return the hash of the file data
+     * @throw Status if the file is not in the archive or is unreadable
+     */
+    quint64 getHash(const BsaFile &file);
+
+    /**
+     * @brief retrieve the hashes of files data, computing the missing ones concurrently on the global thread pool
+     * @param files the files
+     * @return the hashes, in the same order than the given files
+     * @throw Status if a file is not in the archive or is unreadable
+     */
+    QVector<quint64> getHashes(const QVector<BsaFile> &files);
+
+    /**
+     * @brief search the archive files having the same data: files with the same size and the same hash. Only the
+     * files sharing their size with another one are hashed
+     * @return the groups of identical files, each sorted by name, the groups sorted by the name of their first file
+     * @throw Status if a file is unreadable
+     */
+    QVector<QVector<BsaFile>> getDuplicateGroups();
+
+    /**
+     * @brief compute the bytes that would be saved if identical files were stored once
+     * @param duplicateGroups groups of identical files as returned by getDuplicateGroups
+     * @return the size of all the files of the groups but one by group
+     */
+    static qint64 getWastedBytes(const QVector<QVector<BsaFile>> &duplicateGroups);
+
+public slots:
+    /**
+     * @brief forget all the cached hashes
+     */
+    void clearCache();
+
+    /**
+     * @brief forget the cached hashes of the files deleted, new, updated or moved since they were cached
+     */
+    void dropChangedHashes();
+
+private:
+    //**************************************************************************
+    // Types
+    //**************************************************************************
+    /**
+     * @brief hash of an archive file, with the location of the hashed data
+     */
+    struct CachedHash {
+        qint64 offset{0};
+        quint32 size{0};
+        quint64 hash{0};
+    };
+
+    //**************************************************************************
+    // Attributes
+    //**************************************************************************
+    /**
+     * @brief the indexed archive
+     */
+    BsaArchive &mArchive;
+
+    /**
+     * @brief hashes of the archive files, by file name
+     */
+    QHash<QString, CachedHash> mHashCache{};
+
+    //**************************************************************************
+    // Methods
+    //**************************************************************************
+    /**
+     * @brief hash the data of a file, without using the cache
+     * @param file the file
+     * @return the hash of the file data
+     * @throw Status if the file is not in the archive or is unreadable
+     */
+    quint64 computeHash(const BsaFile &file);
+};
+
+#endif // BSATOOL_ARCHIVEINDEX_H
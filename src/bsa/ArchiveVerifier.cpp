@@ -0,0 +1,83 @@
+#include <bsa/ArchiveVerifier.h>
+#include <assets/Cfa.h>
+#include <assets/Dfa.h>
+#include <assets/FileType.h>
+#include <assets/Img.h>
+#include <QElapsedTimer>
+#include <QtConcurrent/QtConcurrent>
+#include <numeric>
+
+//******************************************************************************
+// Methods
+//******************************************************************************
+QVector<ArchiveVerifier::EntryReport> ArchiveVerifier::Report::failures() const {
+    QVector<EntryReport> failedEntries;
+    copy_if(entries.begin(), entries.end(), back_inserter(failedEntries), [](const EntryReport &entry) {
+        return entry.status.code() != 0;
+    });
+    return failedEntries;
+}
+
+bool ArchiveVerifier::Report::isValid() const {
+    return none_of(entries.begin(), entries.end(), [](const EntryReport &entry) {
+        return entry.status.code() != 0;
+    });
+}
+
+ArchiveVerifier::Report ArchiveVerifier::verifyArchive(BsaArchive &archive,
+                                                       const ArchiveConfiguration &configuration) {
+    if (!archive.isOpened()) {
+        throw Status(-1, QStringLiteral("Cannot verify : archive not opened"));
+    }
+    QElapsedTimer timer;
+    timer.start();
+    const QVector<BsaFile> files = archive.getFiles();
+    // Verifying in offset order to keep the archive reads close to each other
+    QVector<int> readOrder(files.size());
+    iota(readOrder.begin(), readOrder.end(), 0);
+    stable_sort(readOrder.begin(), readOrder.end(), [&files](int first, int second) {
+        return files.at(first).startOffsetInArchive() < files.at(second).startOffsetInArchive();
+    });
+    // Each task reads and decodes its file then releases it: memory is bounded by the thread number
+    std::function<EntryReport(int index)> verifyFile = [&](int index) {
+        EntryReport entry;
+        entry.file = files.at(index);
+        QElapsedTimer fileTimer;
+        fileTimer.start();
+        try {
+            entry.decoded = decodeFile(entry.file, archive.getFileData(entry.file), configuration);
+        } catch (Status &e) {
+            entry.status = Status(-1, QString("%1 : %2").arg(entry.file.fileName(), e.message()));
+        }
+        entry.elapsedNanoseconds = fileTimer.nsecsElapsed();
+        return entry;
+    };
+    QVector<EntryReport> verifiedEntries = QtConcurrent::blockingMapped<QVector<EntryReport>>(readOrder, verifyFile);
+    Report report;
+    report.entries.resize(files.size());
+    for (int i(0); i < readOrder.size(); i++) {
+        report.entries[readOrder.at(i)] = verifiedEntries.at(i);
+    }
+    report.elapsedNanoseconds = timer.nsecsElapsed();
+    return report;
+}
+
+bool ArchiveVerifier::decodeFile(const BsaFile &file, const QVector<char> &data,
+                                 const ArchiveConfiguration &configuration) {
+    FileType::Extension extension = FileType::getExtension(file);
+    if (extension == FileType::IMG) {
+        if (configuration.hasConfigurationForFile(file) && configuration.getConfigurationForFile(file).isNoHeader()) {
+            const FileConfiguration &fileConfiguration = configuration.getConfigurationForFile(file);
+            Img img(data, fileConfiguration.getWidth(), fileConfiguration.getHeight());
+        } else {
+            Img img(data);
+        }
+    } else if (extension == FileType::CFA) {
+        Cfa cfa(data);
+    } else if (extension == FileType::DFA) {
+        Dfa dfa(data);
+    } else {
+        return false;
+    }
+    return true;
+}
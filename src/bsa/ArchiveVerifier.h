@@ -0,0 +1,95 @@
+#ifndef BSATOOL_ARCHIVEVERIFIER_H
+#define BSATOOL_ARCHIVEVERIFIER_H
+
+#include <bsa/BsaArchive.h>
+#include <configuration/ArchiveConfiguration.h>
+#include <error/Status.h>
+
+/**
+ * @brief Check that all the files of an archive can be used
+ *
+ * Opening an archive only checks its structure. The verifier reads every file and decodes the known assets (IMG, CFA,
+ * DFA) with their parsers, which uncompress their data. The files are verified concurrently on the global thread
+ * pool, each task reading, decoding then releasing its file, so that only one file per thread is in memory at once
+ */
+class ArchiveVerifier {
+public:
+    /**
+     * @brief Result of the verification of a file
+     */
+    struct EntryReport {
+        /**
+         * @brief the file
+         */
+        BsaFile file{};
+        /**
+         * @brief 0 if the file is valid, -1 with the error otherwise
+         */
+        Status status{0};
+        /**
+         * @brief true if the file is a known asset and was decoded, false if it was only read
+         */
+        bool decoded{false};
+        /**
+         * @brief time spent reading and decoding the file
+         */
+        qint64 elapsedNanoseconds{0};
+    };
+
+    /**
+     * @brief Result of the verification of an archive
+     */
+    struct Report {
+        /**
+         * @brief result of each file, in the order of the archive files list
+         */
+        QVector<EntryReport> entries{};
+        /**
+         * @brief time spent verifying the archive
+         */
+        qint64 elapsedNanoseconds{0};
+
+        /**
+         * @brief results of the invalid files
+         */
+        [[nodiscard]]QVector<EntryReport> failures() const;
+        /**
+         * @brief true if all the files are valid
+         */
+        [[nodiscard]]bool isValid() const;
+    };
+
+    //**************************************************************************
+    // Methods
+    //**************************************************************************
+    /**
+     * @brief read and decode all the files of an archive
+     * @param archive the archive to verify
+     * @param configuration configuration giving the size of the IMG files without header. Required since an IMG
+     * without header missing from it is reported as invalid
+     * @return the result of each file
+     * @throw Status if the archive is not opened
+     */
+    static Report verifyArchive(BsaArchive &archive, const ArchiveConfiguration &configuration);
+
+    /**
+     * @brief decode the data of a file according to its type. Files of unknown type are not decoded
+     * @param file the file
+     * @param data data of the file
+     * @param configuration configuration giving the size of the IMG files without header
+     * @return true if the file was decoded
+     * @throw Status if the data cannot be decoded
+     */
+    static bool decodeFile(const BsaFile &file, const QVector<char> &data, const ArchiveConfiguration &configuration);
+
+private:
+    //**************************************************************************
+    // Constructors
+    //**************************************************************************
+    /**
+     * @brief Constructor
+     */
+    ArchiveVerifier();
+};
+
+#endif // BSATOOL_ARCHIVEVERIFIER_H
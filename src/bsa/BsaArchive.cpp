@@ -1,15 +1,19 @@
 #include <bsa/BsaArchive.h>
 #include <QtConcurrent/QtConcurrent>
+#include <utils/ConcurrentUtils.h>
 #include <utils/FileUtils.h>
+#include <QtEndian>
+#include <numeric>
+
+const QString BsaArchive::JOURNAL_EXT(".journal"); // NOLINT(cert-err58-cpp)
 
 //******************************************************************************
 // Constructors
 //******************************************************************************
-BsaArchive::BsaArchive() {
-    mReadingStream.setByteOrder(QDataStream::LittleEndian);
-}
+BsaArchive::BsaArchive() = default;
 
 BsaArchive::~BsaArchive() {
+    closeReadHandles();
     mArchiveFile.close();
 }
 
@@ -25,6 +29,12 @@ QString BsaArchive::getArchiveFileName() const {
 }
 
 QVector<BsaFile> BsaArchive::getFiles() const {
+    loadFiles();
+    return mFiles;
+}
+
+const QVector<BsaFile> &BsaArchive::files() const {
+    loadFiles();
     return mFiles;
 }
 
@@ -32,86 +42,95 @@ bool BsaArchive::isOpened() const {
     return mOpened;
 }
 
+bool BsaArchive::isMemoryMapped() const {
+    return mMappedData != nullptr;
+}
+
 bool BsaArchive::isModified() const {
-    return isOpened() &&
+    // Any modification builds the files list first
+    return isOpened() && !mFilesPending.loadAcquire() &&
            (mFiles.size() != mOriginalFileNumber ||
             any_of(mFiles.begin(), mFiles.end(), [](const BsaFile &file) { return file.isNew() || file.updated(); }));
 }
 
 qint64 BsaArchive::size() const {
-    auto sizeReduce = [](qint64 &result, const qint64 &current) -> void { result += current; };
-    std::function<qint64(const BsaFile &current)> sizeMap = [](const BsaFile &current) {
-        return qint64(current.updated() ? current.updateFileSize() : current.size());
-    };
-    return QtConcurrent::blockingMappedReduced<qint64>(
-            mFiles, sizeMap, sizeReduce);
+    return mTotalSize;
 }
 
 quint16 BsaArchive::fileNumber() const {
+    if (mFilesPending.loadAcquire()) {
+        return mOriginalFileNumber;
+    }
     return mFiles.size();
 }
 
+BsaFile BsaArchive::getFile(const QString &fileName) const {
+    if (!isOpened()) {
+        return BsaFile::INVALID_BSAFILE;
+    }
+    if (mFilesPending.loadAcquire()) {
+        // The raw file table is released as soon as the files list is built
+        QMutexLocker locker(&mFilesMutex);
+        if (mFilesPending.loadAcquire()) {
+            int record = rawRecordOfFile(fileName);
+            return record == -1 ? BsaFile::INVALID_BSAFILE : rawRecordFile(record);
+        }
+    }
+    int idx = indexOfFile(fileName);
+    return idx == -1 ? BsaFile::INVALID_BSAFILE : mFiles.at(idx);
+}
+
+QString BsaArchive::getModifiedFilePath(const BsaFile &file) const {
+    return mModifiedFilePaths.value(file.fileName());
+}
+
 //**************************************************************************
 // Methods
 //**************************************************************************
-void BsaArchive::openArchive(const QString &filePath) {
+void BsaArchive::openArchive(const QString &filePath, OpenFlags openFlags) {
     if (this->isOpened()) {
         throw Status(-1, QStringLiteral("An archive is already opened"));
     }
-    mArchiveFile.setFileName(filePath);
-    if (!mArchiveFile.open(QIODevice::ReadOnly)) {
-        throw Status(-1, QString("Could not open the file in read mode : %1")
-                .arg(filePath));
+    // Finishing an interrupted incremental save if any
+    if (QFile::exists(filePath + JOURNAL_EXT)) {
+        applyJournal(filePath);
     }
-    // Getting total file fileSize
-    qint64 archiveSize = mArchiveFile.size();
-    // Reading file number
-    mReadingStream.setDevice(&mArchiveFile);
-    mArchiveFile.seek(0);
-    mReadingStream >> mOriginalFileNumber;
-    // Reading files name and fileSize from file table
-    int fileTableSize = FILETABLE_ENTRY_SIZE * mOriginalFileNumber;
-    mArchiveFile.seek(archiveSize - fileTableSize);
-    quint32 offset = 2;
-    char name[14];
-    for (quint16 i(0); i < mOriginalFileNumber; i++) {
-        quint32 fileSize = 0;
-        if (mArchiveFile.atEnd()) {
-            throw Status(-1, QString("Reached end of file while reading infos of file %1 of %2")
-                    .arg(i + 1).arg(mOriginalFileNumber));
-        }
-        if (mReadingStream.readRawData(&name[0], 14) < 14) {
-            throw Status(-1, QString("Could not read file name of file %1 of %2")
-                    .arg(i + 1).arg(mOriginalFileNumber));
+    openArchiveFile(filePath, openFlags);
+    try {
+        readFileTable();
+        if (openFlags.testFlag(LAZY_FILE_TABLE)) {
+            buildRawIndex();
+        } else {
+            buildFilesFromRawTable();
+            clearRawFileTable();
         }
-        mReadingStream >> fileSize;
-        mFiles.append(BsaFile(fileSize, offset, QString(&name[0])));
-        offset += fileSize;
-    }
-    // Checking archive fileSize and integrity
-    auto totalSizeFromFiles = size();
-    totalSizeFromFiles += 2 + fileTableSize;
-    if (totalSizeFromFiles != archiveSize) {
-        throw Status(-1, QString("The archive seems corrupted (actual fileSize : %1, expected fileSize : %2")
-                .arg(archiveSize).arg(totalSizeFromFiles));
+    } catch (Status &) {
+        closeArchiveFile();
+        clearRawFileTable();
+        mFiles.clear();
+        mTotalSize = 0;
+        mOriginalFileNumber = 0;
+        throw;
     }
-    // Sorting file list by name
-    sort(mFiles.begin(), mFiles.end());
     // Archive has been read and ok -> opened
     mOpened = true;
     emit archiveOpened(true);
-    emit fileListModified(mFiles);
+    // The files list is only sent once built
+    if (!mFilesPending.loadAcquire()) {
+        emit fileListModified(mFiles);
+    }
 }
 
 void BsaArchive::closeArchive() {
     if (!this->isOpened()) {
         throw Status(-1, QStringLiteral("Cannot close : archive not opened"));
     }
-    if (mArchiveFile.openMode() != QIODevice::NotOpen) {
-        mArchiveFile.close();
-    }
-    mReadingStream.setDevice(nullptr);
+    mFilesPending.storeRelease(0);
+    clearRawFileTable();
+    closeArchiveFile();
     mFiles.clear();
+    mModifiedFilePaths.clear();
+    mTotalSize = 0;
     mOriginalFileNumber = 0;
     mOpened = false;
     emit fileListModified(mFiles);
@@ -119,110 +138,244 @@ void BsaArchive::closeArchive() {
 }
 
 QVector<char> BsaArchive::getFileData(const BsaFile &file) {
-    int idx = verifyArchiveOpenAndFileExists(file);
-    auto &internFile = mFiles.at(idx);
+    BsaFile internFile = verifyArchiveOpenAndGetFile(file);
     QVector<char> data;
     // External file
     if (internFile.isNew() || internFile.updated()) {
-        QByteArray byteArray = FileUtils::readDataFromFile(file.modifiedFilePath());
+        QByteArray byteArray = FileUtils::readDataFromFile(getModifiedFilePath(internFile));
         data = QVector<char>(byteArray.begin(), byteArray.end());
+    }
+        // Copy from the memory mapped archive
+    else if (mMappedData != nullptr) {
+        const char *start = reinterpret_cast<const char *>(mMappedData) + internFile.startOffsetInArchive();
+        data = QVector<char>(start, start + internFile.size());
     }
         // Read from archive
     else {
-        if (!mArchiveFile.seek(internFile.startOffsetInArchive())) {
-            throw Status(-1, QStringLiteral("The file data is unreadable"));
-        }
         data = QVector<char>(int(internFile.size()));
-        int bytesRead = mReadingStream.readRawData(data.data(), int(internFile.size()));
-        if (internFile.size() != bytesRead) {
-            throw Status(-1, QString("Could not retrieve all the data got %1, expected %2")
-                    .arg(bytesRead, int(internFile.size())));
-        }
+        readArchiveData(internFile.startOffsetInArchive(), data.data(), internFile.size());
     }
     return data;
 }
 
-void BsaArchive::extractFile(const QString &destinationFolder, const BsaFile &file) {
-    int idx = verifyArchiveOpenAndFileExists(file);
-    auto &internFile = mFiles.at(idx);
-    QFile saveFile(destinationFolder + QDir::separator() + internFile.fileName());
-    if (!saveFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
-        throw Status(-1, QString("Could not open the file in write mode : %1")
-                .arg(saveFile.fileName()));
+QVector<QVector<char>> BsaArchive::getFilesData(const QVector<BsaFile> &files) {
+    QVector<QVector<char>> filesData = ConcurrentUtils::blockingMapped<QVector<char>>(
+            files, [this](const BsaFile &file) { return getFileData(file); },
+            [](const BsaFile &file) { return file.fileName(); }, QStringLiteral("Unable to read files data"));
+    return filesData;
+}
+
+DataView BsaArchive::getFileView(const BsaFile &file) {
+    BsaFile internFile = verifyArchiveOpenAndGetFile(file);
+    if (mMappedData == nullptr) {
+        throw Status(-1, QStringLiteral("The archive is not memory mapped"));
+    }
+    if (internFile.isNew() || internFile.updated()) {
+        throw Status(-1, QString("The file %1 is new or updated: its data is not in the archive")
+                .arg(internFile.fileName()));
     }
-    QDataStream writeStream(&saveFile);
-    writeStream.setByteOrder(QDataStream::LittleEndian);
+    return {reinterpret_cast<const char *>(mMappedData) + internFile.startOffsetInArchive(),
+            qint64(internFile.size())};
+}
+
+void BsaArchive::extractFile(const QString &destinationFolder, const BsaFile &file) {
+    BsaFile internFile = verifyArchiveOpenAndGetFile(file);
     QVector<char> data = getFileData(internFile);
-    int bytesWritten = writeStream.writeRawData(data.constData(), data.size());
-    if (bytesWritten < data.size()) {
-        throw Status(-1, QString("Only %1 bytes of %2 written to file %3")
-                .arg(bytesWritten)
-                .arg(data.size())
-                .arg(saveFile.fileName()));
+    FileUtils::writeDataToFile(destinationFolder + QDir::separator() + internFile.fileName(),
+                               data.constData(), data.size());
+}
+
+QVector<Status> BsaArchive::extractFiles(const QString &destinationFolder, const QVector<BsaFile> &files) {
+    if (!this->isOpened()) {
+        throw Status(-1, QStringLiteral("The archive is not opened"));
     }
-    saveFile.flush();
-    saveFile.close();
+    // Reading in offset order to keep the archive reads sequential
+    QVector<int> readOrder(files.size());
+    iota(readOrder.begin(), readOrder.end(), 0);
+    stable_sort(readOrder.begin(), readOrder.end(), [&files](int first, int second) {
+        return files.at(first).startOffsetInArchive() < files.at(second).startOffsetInArchive();
+    });
+    QVector<Status> results(files.size(), Status(0));
+    int extractedNumber(0);
+    // Writes running on the thread pool. Bounded to limit the data waiting in memory
+    QVector<QPair<int, QFuture<QString>>> pendingWrites;
+    const int maxPendingWrites = QThreadPool::globalInstance()->maxThreadCount() * 2;
+    auto waitOldestWrite = [&]() {
+        auto pendingWrite = pendingWrites.takeFirst();
+        QString errorMessage = pendingWrite.second.result();
+        if (!errorMessage.isEmpty()) {
+            results[pendingWrite.first] = Status(-1, errorMessage);
+        }
+        emit extractionProgress(++extractedNumber, files.size());
+    };
+    for (int idx : readOrder) {
+        const BsaFile &file = files.at(idx);
+        QString filePath = destinationFolder + QDir::separator() + file.fileName();
+        // Memory mapped data is written without copy, the other is read in the calling thread
+        QVector<char> data;
+        DataView view;
+        try {
+            BsaFile internFile = verifyArchiveOpenAndGetFile(file);
+            if (isMemoryMapped() && !internFile.isNew() && !internFile.updated()) {
+                view = getFileView(internFile);
+            } else {
+                data = getFileData(internFile);
+            }
+        } catch (Status &e) {
+            results[idx] = Status(-1, QString("Could not extract file %1 : %2").arg(file.fileName(), e.message()));
+            emit extractionProgress(++extractedNumber, files.size());
+            continue;
+        }
+        pendingWrites.append(qMakePair(idx, QtConcurrent::run([filePath, data, view]() {
+            try {
+                if (view.data() != nullptr) {
+                    FileUtils::writeDataToFile(filePath, view.data(), view.size());
+                } else {
+                    FileUtils::writeDataToFile(filePath, data.constData(), data.size());
+                }
+            } catch (Status &e) {
+                return e.message();
+            }
+            return QString();
+        })));
+        if (pendingWrites.size() >= maxPendingWrites) {
+            waitOldestWrite();
+        }
+    }
+    while (!pendingWrites.isEmpty()) {
+        waitOldestWrite();
+    }
+    return results;
+}
+
+QVector<Status> BsaArchive::extractAll(const QString &destinationFolder) {
+    loadFiles();
+    return extractFiles(destinationFolder, mFiles);
 }
 
 BsaFile BsaArchive::deleteFile(const BsaFile &file) {
+    loadFiles();
     int idx = verifyArchiveOpenAndFileExists(file);
     BsaFile removedFile = mFiles.takeAt(idx);
+    mModifiedFilePaths.remove(removedFile.fileName());
+    mTotalSize -= removedFile.dataSize();
+    FileListDelta delta;
+    delta.removedIndexes.append(idx);
+    emit fileListChanged(delta);
     emit fileListModified(mFiles);
     return removedFile;
 }
 
 BsaFile BsaArchive::addOrUpdateFile(const QString &filePath) {
-    QFile newFile(filePath);
-    // New file should exist and be readable for size
-    if (!newFile.exists() || !newFile.open(QIODevice::ReadOnly)) {
-        throw Status(-1, QString("The file %1 doesn't exist or is not readable").arg(filePath));
-    }
-    auto newFileSize = static_cast<quint32>(newFile.size());
-    QString newFileName = QFileInfo(newFile).fileName().toUpper();
-    newFile.close();
+    loadFiles();
+    BsaFile newBsaFile = createNewBsaFile(filePath);
+    mModifiedFilePaths.insert(newBsaFile.fileName(), filePath);
     // Checking if file already exists in archive
-    BsaFile newBsaFile(newFileSize, 2, newFileName);
-    newBsaFile.setIsNew(true);
-    newBsaFile.setModifiedFilePath(filePath);
-    int idx = mFiles.indexOf(newBsaFile);
-    // new File
-    if (idx == -1) {
-        mFiles.append(newBsaFile);
-        sort(mFiles.begin(), mFiles.end());
+    int idx = lowerBoundOfFile(newBsaFile.fileName());
+    // new File, inserted at its place to keep the list sorted
+    FileListDelta delta;
+    if (idx == mFiles.size() || mFiles.at(idx) != newBsaFile) {
+        mFiles.insert(idx, newBsaFile);
+        mTotalSize += newBsaFile.dataSize();
+        delta.insertedIndexes.append(idx);
+        emit fileListChanged(delta);
         emit fileListModified(mFiles);
         return newBsaFile;
     }
         // File already exists
     else {
-        auto &internFile = mFiles[idx];
-        // updating an already new file
-        if (internFile.isNew()) {
-            mFiles.replace(idx, newBsaFile);
-            emit fileModified(newBsaFile);
-            return newBsaFile;
+        mTotalSize -= mFiles.at(idx).dataSize();
+        mFiles.replace(idx, mergeUpdate(mFiles.at(idx), newBsaFile));
+        mTotalSize += mFiles.at(idx).dataSize();
+        delta.modifiedIndexes.append(idx);
+        emit fileListChanged(delta);
+        emit fileModified(mFiles.at(idx));
+        return mFiles.at(idx);
+    }
+}
+
+QVector<BsaFile> BsaArchive::addOrUpdateFiles(const QStringList &filePaths) {
+    loadFiles();
+    // Building all the files before any change so that the archive is untouched if one is invalid
+    QVector<BsaFile> newBsaFiles;
+    newBsaFiles.reserve(filePaths.size());
+    for (const auto &filePath : filePaths) {
+        newBsaFiles.append(createNewBsaFile(filePath));
+    }
+    // Sorting by name. Stable so that the last given path wins for a duplicated name
+    QVector<int> newFilesOrder(newBsaFiles.size());
+    iota(newFilesOrder.begin(), newFilesOrder.end(), 0);
+    stable_sort(newFilesOrder.begin(), newFilesOrder.end(), [&newBsaFiles](int first, int second) {
+        return newBsaFiles.at(first) < newBsaFiles.at(second);
+    });
+    // Merging the two sorted lists in one pass
+    QVector<BsaFile> mergedFiles;
+    mergedFiles.reserve(mFiles.size() + newBsaFiles.size());
+    FileListDelta delta;
+    QVector<BsaFile> updatedFiles;
+    qint64 totalSize(mTotalSize);
+    int fileIdx(0);
+    for (int orderIdx(0); orderIdx < newFilesOrder.size(); orderIdx++) {
+        const BsaFile &newBsaFile = newBsaFiles.at(newFilesOrder.at(orderIdx));
+        // Only the last of the duplicated names is kept
+        if (orderIdx + 1 < newFilesOrder.size() && newBsaFiles.at(newFilesOrder.at(orderIdx + 1)) == newBsaFile) {
+            continue;
         }
-            // updating normal file
+        mModifiedFilePaths.insert(newBsaFile.fileName(), filePaths.at(newFilesOrder.at(orderIdx)));
+        while (fileIdx < mFiles.size() && mFiles.at(fileIdx) < newBsaFile) {
+            mergedFiles.append(mFiles.at(fileIdx++));
+        }
+        // File already exists
+        if (fileIdx < mFiles.size() && mFiles.at(fileIdx) == newBsaFile) {
+            delta.modifiedIndexes.append(mergedFiles.size());
+            totalSize -= mFiles.at(fileIdx).dataSize();
+            mergedFiles.append(mergeUpdate(mFiles.at(fileIdx++), newBsaFile));
+        }
+            // new File
         else {
-            internFile.setUpdated(true);
-            internFile.setModifiedFilePath(filePath);
-            internFile.setUpdateFileSize(newFileSize);
-            emit fileModified(internFile);
-            return internFile;
+            delta.insertedIndexes.append(mergedFiles.size());
+            mergedFiles.append(newBsaFile);
         }
+        totalSize += mergedFiles.last().dataSize();
+        updatedFiles.append(mergedFiles.last());
+    }
+    while (fileIdx < mFiles.size()) {
+        mergedFiles.append(mFiles.at(fileIdx++));
     }
+    mFiles = std::move(mergedFiles);
+    mTotalSize = totalSize;
+    emit fileListChanged(delta);
+    // Same signals as adding or updating the files one by one, but the list is sent once
+    if (!delta.insertedIndexes.isEmpty()) {
+        emit fileListModified(mFiles);
+    }
+    for (int modifiedIdx : delta.modifiedIndexes) {
+        emit fileModified(mFiles.at(modifiedIdx));
+    }
+    return updatedFiles;
 }
 
 BsaFile BsaArchive::revertChanges(const BsaFile &file) {
+    loadFiles();
     int idx = verifyArchiveOpenAndFileExists(file);
     auto &internFile = mFiles[idx];
-    // Noting to be done if file not to delete
-    if (!internFile.isNew()) {
+    // A new file is deleted
+    if (internFile.isNew()) {
         return deleteFile(internFile);
     }
+    // Nothing to be done if file not updated
+    if (!internFile.updated()) {
+        return internFile;
+    }
     // Updating file state
+    mTotalSize -= internFile.dataSize();
     internFile.setUpdated(false);
-    internFile.setModifiedFilePath(QString());
+    mModifiedFilePaths.remove(internFile.fileName());
     internFile.setUpdateFileSize(0);
+    mTotalSize += internFile.dataSize();
+    FileListDelta delta;
+    delta.modifiedIndexes.append(idx);
+    emit fileListChanged(delta);
     emit fileModified(internFile);
     return internFile;
 }
@@ -234,7 +387,9 @@ void BsaArchive::createNewArchive() {
     // init empty archive data
     mArchiveFile.setFileName("");
     mFiles.clear();
-    mReadingStream.setDevice(nullptr);
+    mModifiedFilePaths.clear();
+    mTotalSize = 0;
+    mOpenFlags = NO_OPEN_FLAG;
     mOriginalFileNumber = 0;
     mOpened = true;
     emit archiveOpened(true);
@@ -245,51 +400,35 @@ void BsaArchive::saveArchive(const QString &filePath) {
     if (!this->isOpened()) {
         throw Status(-1, QStringLiteral("Cannot save archive: not opened"));
     }
+    loadFiles();
     QFile saveFile(filePath + ".tmp");
-    if (!saveFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+    if (!saveFile.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Unbuffered)) {
         throw Status(-1, QString("Cannot save archive: could not write temporary file %1")
                 .arg(saveFile.fileName()));
     }
-    QDataStream saveStream(&saveFile);
-    saveStream.setByteOrder(QDataStream::LittleEndian);
     size_t totalFileSize(0);
     quint16 nbFileToSave(mFiles.size());
     try {
         // Writing header
-        saveStream << nbFileToSave;
-        // Writing files data
-        for (quint16 i(0); i < quint16(mFiles.size()); i++) {
-            const BsaFile &file = mFiles.at(i);
-            // Retrieve file data
-            QVector<char> fileData = std::move(getFileData(file));
-            int dataSize = int(file.updated() ? file.updateFileSize() : file.size());
-            // Writing file data
-            int bytesWritten = saveStream.writeRawData(fileData.data(), dataSize);
-            // Error writing data
-            if (bytesWritten != dataSize) {
-                throw Status(-1, QString("Error while writing data for file %1. Got only %2 bytes of %3")
-                        .arg(file.fileName()).arg(bytesWritten)
-                        .arg(dataSize));
+        quint16 header = qToLittleEndian(nbFileToSave);
+        if (saveFile.write(reinterpret_cast<const char *>(&header), 2) != 2) {
+            throw Status(-1, QStringLiteral("Error while writing the archive header"));
+        }
+        // Writing files data through a fixed size buffer
+        QVector<char> copyBuffer(COPY_BUFFER_SIZE);
+        for (const auto &file : qAsConst(mFiles)) {
+            try {
+                writeFileData(saveFile, file, copyBuffer);
+            } catch (Status &e) {
+                throw Status(-1, QString("Error while writing data for file %1 : %2")
+                        .arg(file.fileName(), e.message()));
             }
-            totalFileSize += bytesWritten;
+            totalFileSize += file.dataSize();
         }
         // Writing file table
-        char nullString[14] = {0};
-        for (quint16 i(0); i < quint16(mFiles.size()); i++) {
-            const BsaFile &file = mFiles.at(i);
-            // Writing file name and padding to 14 bytes
-            int nameBytes = saveStream.writeRawData(file.fileName().toStdString().c_str(),
-                                                    file.fileName().size());
-            int paddingBytes = saveStream.writeRawData(&nullString[0],
-                                                       14 - file.fileName().size());
-            // Error writing data
-            if (nameBytes + paddingBytes != 14) {
-                throw Status(-1, QString("Error while writing data in file table for file %1")
-                        .arg(file.fileName()));
-            }
-            // Writing file size
-            quint32 dataSize = file.updated() ? file.updateFileSize() : file.size();
-            saveStream << dataSize;
+        QByteArray fileTable = buildFileTable(mFiles);
+        if (saveFile.write(fileTable) != fileTable.size()) {
+            throw Status(-1, QStringLiteral("Error while writing the file table"));
         }
     } catch (Status &e) {
         saveFile.close();
@@ -309,32 +448,496 @@ void BsaArchive::saveArchive(const QString &filePath) {
         throw Status(-1, QString("Temporary file not properly saved: saved size: %1, expected: %2. Nothing done")
                 .arg(savedSize).arg(expectedSize));
     }
+    // Releasing the opened archive file, which may be the one replaced
+    const QString openedFilePath = mArchiveFile.fileName();
+    closeArchiveFile();
+    auto restoreOpenedFile = [this, &openedFilePath]() {
+        if (openedFilePath.isEmpty()) {
+            return;
+        }
+        if (QFile::exists(openedFilePath)) {
+            openArchiveFile(openedFilePath, mOpenFlags);
+        } else {
+            closeArchive();
+        }
+    };
     // Writing final file
     QFile finalFile(filePath);
     // Trying to delete existing if exists
     if (finalFile.exists()) {
         if (!finalFile.remove()) {
+            restoreOpenedFile();
             throw Status(-1, QString("Could not delete existing file %1. Temporary saved archive can be found at %2")
                     .arg(finalFile.fileName(), saveFile.fileName()));
         }
     }
     // Renaming temporary
     if (!saveFile.rename(finalFile.fileName())) {
+        restoreOpenedFile();
         throw Status(-1, QString("Could not rename temporary saved archive %1 to %2. Saved archive can be found at %1")
                 .arg(saveFile.fileName(), finalFile.fileName()));
     }
-    // Reloading Archive
-    closeArchive();
-    openArchive(filePath);
+    // Files were saved in list order: updating offsets without reading the saved archive
+    try {
+        reloadFromLayout(filePath, mFiles);
+    } catch (Status &e) {
+        closeArchive();
+        throw Status(-1, QString("Archive saved to %1 but could not be opened again : %2")
+                .arg(filePath, e.message()));
+    }
+}
+
+void BsaArchive::readFileTable() {
+    qint64 archiveSize = mArchiveFile.size();
+    if (archiveSize < 2) {
+        throw Status(-1, QString("The archive seems corrupted (actual fileSize : %1, no file number)")
+                .arg(archiveSize));
+    }
+    // Reading file number
+    quint16 fileNumber(0);
+    if (mMappedData != nullptr) {
+        fileNumber = qFromLittleEndian<quint16>(mMappedData);
+    } else {
+        readArchiveData(0, reinterpret_cast<char *>(&fileNumber), 2);
+        fileNumber = qFromLittleEndian(fileNumber);
+    }
+    qint64 fileTableSize = qint64(FILETABLE_ENTRY_SIZE) * fileNumber;
+    if (2 + fileTableSize > archiveSize) {
+        throw Status(-1, QString("The archive seems corrupted (actual fileSize : %1, file table size : %2")
+                .arg(archiveSize).arg(fileTableSize));
+    }
+    // Getting the whole file table at once
+    if (mMappedData != nullptr) {
+        mRawFileTable = QByteArray::fromRawData(
+                reinterpret_cast<const char *>(mMappedData) + archiveSize - fileTableSize, int(fileTableSize));
+    } else {
+        mRawFileTable.resize(int(fileTableSize));
+        readArchiveData(archiveSize - fileTableSize, mRawFileTable.data(), fileTableSize);
+    }
+    // Checking names and computing files offsets from their sizes
+    const char *entry = mRawFileTable.constData();
+    mRawOffsets.resize(fileNumber);
+    qint64 offset(2);
+    for (int i(0); i < fileNumber; i++, entry += FILETABLE_ENTRY_SIZE) {
+        if (qstrnlen(entry, 14) > 13) {
+            throw Status(-1, QString("The name of file %1 of %2 is too long (maximum allowed : 13 characters)")
+                    .arg(i + 1).arg(fileNumber));
+        }
+        mRawOffsets[i] = offset;
+        offset += qFromLittleEndian<quint32>(entry + 14);
+    }
+    // Checking archive fileSize and integrity
+    qint64 totalSizeFromFiles = offset + fileTableSize;
+    if (totalSizeFromFiles != archiveSize) {
+        throw Status(-1, QString("The archive seems corrupted (actual fileSize : %1, expected fileSize : %2")
+                .arg(archiveSize).arg(totalSizeFromFiles));
+    }
+    mTotalSize = offset - 2;
+    mOriginalFileNumber = fileNumber;
+}
+
+void BsaArchive::buildRawIndex() {
+    mRawIndex.resize(mOriginalFileNumber);
+    iota(mRawIndex.begin(), mRawIndex.end(), quint16(0));
+    const char *fileTable = mRawFileTable.constData();
+    sort(mRawIndex.begin(), mRawIndex.end(), [fileTable](quint16 first, quint16 second) {
+        return qstrncmp(fileTable + first * FILETABLE_ENTRY_SIZE, fileTable + second * FILETABLE_ENTRY_SIZE, 14) < 0;
+    });
+    mFilesPending.storeRelease(1);
+}
+
+void BsaArchive::buildFilesFromRawTable() const {
+    mFiles.reserve(mOriginalFileNumber);
+    for (int i(0); i < mOriginalFileNumber; i++) {
+        mFiles.append(rawRecordFile(i));
+    }
+    // Sorting file list by name
+    sort(mFiles.begin(), mFiles.end());
+}
+
+void BsaArchive::loadFiles() const {
+    if (!mFilesPending.loadAcquire()) {
+        return;
+    }
+    QMutexLocker locker(&mFilesMutex);
+    if (mFilesPending.loadAcquire()) {
+        buildFilesFromRawTable();
+        mFilesPending.storeRelease(0);
+        // The files list replaces the raw file table
+        clearRawFileTable();
+    }
+}
+
+void BsaArchive::clearRawFileTable() const {
+    mRawFileTable.clear();
+    mRawOffsets.clear();
+    mRawIndex.clear();
+}
+
+BsaFile BsaArchive::rawRecordFile(int record) const {
+    const char *entry = mRawFileTable.constData() + record * FILETABLE_ENTRY_SIZE;
+    return BsaFile(qFromLittleEndian<quint32>(entry + 14), mRawOffsets.at(record), entry);
+}
+
+int BsaArchive::rawRecordOfFile(const QString &fileName) const {
+    if (fileName.size() > 13) {
+        return -1;
+    }
+    QByteArray name = fileName.toLatin1();
+    const char *fileTable = mRawFileTable.constData();
+    auto it = lower_bound(mRawIndex.begin(), mRawIndex.end(), name, [fileTable](quint16 record,
+                                                                                const QByteArray &searched) {
+        return qstrncmp(fileTable + record * FILETABLE_ENTRY_SIZE, searched.constData(), 14) < 0;
+    });
+    // Checking the full name in case of a name not representable in latin1
+    if (it == mRawIndex.end() ||
+        QString::fromLatin1(fileTable + *it * FILETABLE_ENTRY_SIZE,
+                            int(qstrnlen(fileTable + *it * FILETABLE_ENTRY_SIZE, 14))) != fileName) {
+        return -1;
+    }
+    return *it;
+}
+
+void BsaArchive::saveArchiveIncrementally() {
+    if (!this->isOpened()) {
+        throw Status(-1, QStringLiteral("Cannot save archive: not opened"));
+    }
+    loadFiles();
+    const QString filePath = mArchiveFile.fileName();
+    if (filePath.isEmpty()) {
+        throw Status(-1, QStringLiteral("Cannot save archive incrementally: the archive has never been saved"));
+    }
+    if (!isModified()) {
+        return;
+    }
+    // Archive files in the order of their data: archive files by offset, then new files
+    QVector<BsaFile> layout;
+    layout.reserve(mFiles.size());
+    for (const auto &file : qAsConst(mFiles)) {
+        if (!file.isNew()) {
+            layout.append(file);
+        }
+    }
+    stable_sort(layout.begin(), layout.end(), [](const BsaFile &first, const BsaFile &second) {
+        return first.startOffsetInArchive() < second.startOffsetInArchive();
+    });
+    for (const auto &file : qAsConst(mFiles)) {
+        if (file.isNew()) {
+            layout.append(file);
+        }
+    }
+    // Searching the end of the data kept as is: stops at the first updated file or deleted file gap
+    qint64 prefixEnd(2);
+    int prefixFileNumber(0);
+    while (prefixFileNumber < layout.size()) {
+        const BsaFile &file = layout.at(prefixFileNumber);
+        if (file.isNew() || file.updated() || file.startOffsetInArchive() != prefixEnd) {
+            break;
+        }
+        prefixEnd += file.size();
+        prefixFileNumber++;
+    }
+    // Writing the new tail of the archive in the journal. The archive is not touched until the journal is complete
+    QFile journal(filePath + JOURNAL_EXT);
+    if (!journal.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Unbuffered)) {
+        throw Status(-1, QString("Cannot save archive: could not write journal file %1")
+                .arg(journal.fileName()));
+    }
+    try {
+        // Header with an impossible tail size until the tail is fully written
+        QDataStream journalStream(&journal);
+        journalStream.setByteOrder(QDataStream::LittleEndian);
+        journalStream << quint64(prefixEnd) << quint16(layout.size()) << quint64(-1);
+        QVector<char> copyBuffer(COPY_BUFFER_SIZE);
+        for (int i(prefixFileNumber); i < layout.size(); i++) {
+            const BsaFile &file = layout.at(i);
+            try {
+                writeFileData(journal, file, copyBuffer);
+            } catch (Status &e) {
+                throw Status(-1, QString("Error while writing data for file %1 : %2")
+                        .arg(file.fileName(), e.message()));
+            }
+        }
+        QByteArray fileTable = buildFileTable(layout);
+        if (journal.write(fileTable) != fileTable.size()) {
+            throw Status(-1, QStringLiteral("Error while writing the file table"));
+        }
+        // The tail must be on disk before the header validates it
+        FileUtils::syncFile(journal);
+        // Validating the journal with the real tail size
+        quint64 tailSize = journal.size() - JOURNAL_HEADER_SIZE;
+        journal.seek(JOURNAL_HEADER_SIZE - 8);
+        journalStream << tailSize;
+        if (journalStream.status() != QDataStream::Ok) {
+            throw Status(-1, QStringLiteral("Error while writing the journal header"));
+        }
+        // The journal must be complete on disk before the archive is patched in place
+        FileUtils::syncFile(journal);
+    } catch (Status &e) {
+        journal.close();
+        journal.remove();
+        throw Status(-1, "Unable to save archive data : " + e.message());
+    }
+    journal.close();
+    // Rewriting the archive tail from the journal
+    closeArchiveFile();
+    try {
+        applyJournal(filePath);
+        reloadFromLayout(filePath, layout);
+    } catch (Status &e) {
+        closeArchive();
+        throw Status(-1, QString("Unable to save archive data : %1. The archive has been closed, the save will be "
+                                 "finished on next opening").arg(e.message()));
+    }
+}
+
+void BsaArchive::applyJournal(const QString &filePath) {
+    QFile journal(filePath + JOURNAL_EXT);
+    if (!journal.open(QIODevice::ReadOnly)) {
+        throw Status(-1, QString("Could not open the file in read mode : %1")
+                .arg(journal.fileName()));
+    }
+    QDataStream journalStream(&journal);
+    journalStream.setByteOrder(QDataStream::LittleEndian);
+    quint64 prefixEnd(0), tailSize(0);
+    quint16 fileNumber(0);
+    journalStream >> prefixEnd >> fileNumber >> tailSize;
+    // Incomplete journal: the archive has not been touched yet
+    if (journalStream.status() != QDataStream::Ok || quint64(journal.size()) != JOURNAL_HEADER_SIZE + tailSize) {
+        journal.close();
+        journal.remove();
+        return;
+    }
+    // Replaying the journal. Replaying it again after an interruption gives the same result
+    QFile archiveFile(filePath);
+    if (!archiveFile.open(QIODevice::ReadWrite | QIODevice::Unbuffered)) {
+        throw Status(-1, QString("Could not open the file in write mode : %1")
+                .arg(filePath));
+    }
+    QVector<char> copyBuffer(COPY_BUFFER_SIZE);
+    if (!archiveFile.seek(qint64(prefixEnd))) {
+        throw Status(-1, QString("Could not reach the end of the unchanged data in %1").arg(filePath));
+    }
+    FileUtils::copyData(journal, archiveFile, qint64(tailSize), copyBuffer);
+    quint16 header = qToLittleEndian(fileNumber);
+    if (!archiveFile.resize(qint64(prefixEnd + tailSize)) || !archiveFile.seek(0) ||
+        archiveFile.write(reinterpret_cast<const char *>(&header), 2) != 2 || !archiveFile.flush()) {
+        throw Status(-1, QString("Could not finish writing %1").arg(filePath));
+    }
+    // The patched archive must be on disk before the journal is dropped
+    FileUtils::syncFile(archiveFile);
+    archiveFile.close();
+    journal.close();
+    journal.remove();
+}
+
+void BsaArchive::reloadFromLayout(const QString &filePath, const QVector<BsaFile> &layout) {
+    // Files data are stored one after the other in layout order
+    QVector<BsaFile> savedFiles;
+    savedFiles.reserve(layout.size());
+    qint64 offset(2);
+    for (const auto &file : layout) {
+        quint32 fileSize = file.dataSize();
+        savedFiles.append(BsaFile(fileSize, offset, file.rawFileName()));
+        offset += fileSize;
+    }
+    sort(savedFiles.begin(), savedFiles.end());
+    mFiles = std::move(savedFiles);
+    mModifiedFilePaths.clear();
+    mTotalSize = offset - 2;
+    mOriginalFileNumber = mFiles.size();
+    clearRawFileTable();
+    openArchiveFile(filePath, mOpenFlags);
+    emit fileListModified(mFiles);
+}
+
+void BsaArchive::openArchiveFile(const QString &filePath, OpenFlags openFlags) {
+    mArchiveFile.setFileName(filePath);
+    if (!mArchiveFile.open(QIODevice::ReadOnly)) {
+        throw Status(-1, QString("Could not open the file in read mode : %1")
+                .arg(filePath));
+    }
+    // Mapping the whole archive if asked
+    if (openFlags.testFlag(MEMORY_MAPPED)) {
+        mMappedData = mArchiveFile.map(0, mArchiveFile.size());
+        if (mMappedData == nullptr) {
+            mArchiveFile.close();
+            throw Status(-1, QString("Could not map the file in memory : %1")
+                    .arg(filePath));
+        }
+    }
+    mOpenFlags = openFlags;
+}
+
+void BsaArchive::closeArchiveFile() {
+    if (mMappedData != nullptr) {
+        mArchiveFile.unmap(mMappedData);
+        mMappedData = nullptr;
+    }
+    if (mArchiveFile.openMode() != QIODevice::NotOpen) {
+        mArchiveFile.close();
+    }
+    closeReadHandles();
+}
+
+BsaFile BsaArchive::verifyArchiveOpenAndGetFile(const BsaFile &file) const {
+    if (!this->isOpened()) {
+        throw Status(-1, QStringLiteral("The archive is not opened"));
+    }
+    if (mFilesPending.loadAcquire()) {
+        QMutexLocker locker(&mFilesMutex);
+        if (mFilesPending.loadAcquire()) {
+            int record = rawRecordOfFile(file.fileName());
+            if (record == -1) {
+                throw Status(-1, QStringLiteral("The file is not in the archive"));
+            }
+            return rawRecordFile(record);
+        }
+    }
+    int idx = indexOfFile(file.fileName());
+    if (idx == -1) {
+        throw Status(-1, QStringLiteral("The file is not in the archive"));
+    }
+    return mFiles.at(idx);
 }
 
 int BsaArchive::verifyArchiveOpenAndFileExists(const BsaFile &file) {
     if (!this->isOpened()) {
         throw Status(-1, QStringLiteral("The archive is not opened"));
     }
-    int idx = mFiles.indexOf(file);
+    int idx = indexOfFile(file.fileName());
     if (idx == -1) {
         throw Status(-1, QStringLiteral("The file is not in the archive"));
     }
     return idx;
 }
+
+void BsaArchive::writeFileData(QFile &destination, const BsaFile &file, QVector<char> &buffer) {
+    qint64 dataSize = file.dataSize();
+    // External file
+    if (file.isNew() || file.updated()) {
+        QFile source(getModifiedFilePath(file));
+        if (!source.open(QIODevice::ReadOnly | QIODevice::Unbuffered)) {
+            throw Status(-1, QString("Could not open the file in read mode : %1")
+                    .arg(source.fileName()));
+        }
+        FileUtils::copyData(source, destination, dataSize, buffer);
+    }
+        // Written straight from the memory mapped archive
+    else if (mMappedData != nullptr) {
+        qint64 bytesWritten = destination.write(
+                reinterpret_cast<const char *>(mMappedData) + file.startOffsetInArchive(), dataSize);
+        if (bytesWritten != dataSize) {
+            throw Status(-1, QString("Only %1 bytes of %2 written").arg(bytesWritten).arg(dataSize));
+        }
+    }
+        // Copied from archive
+    else {
+        QFile *readHandle = acquireReadHandle();
+        try {
+            if (!readHandle->seek(file.startOffsetInArchive())) {
+                throw Status(-1, QStringLiteral("The file data is unreadable"));
+            }
+            FileUtils::copyData(*readHandle, destination, dataSize, buffer);
+        } catch (Status &) {
+            releaseReadHandle(readHandle);
+            throw;
+        }
+        releaseReadHandle(readHandle);
+    }
+}
+
+QByteArray BsaArchive::buildFileTable(const QVector<BsaFile> &files) {
+    QByteArray fileTable(files.size() * FILETABLE_ENTRY_SIZE, '\0');
+    char *entry = fileTable.data();
+    for (const auto &file : files) {
+        // File name padded with zeros to 14 bytes
+        memcpy(entry, file.rawFileName(), 14);
+        // File size
+        qToLittleEndian(file.dataSize(), entry + 14);
+        entry += FILETABLE_ENTRY_SIZE;
+    }
+    return fileTable;
+}
+
+int BsaArchive::indexOfFile(const QString &fileName) const {
+    int idx = lowerBoundOfFile(fileName);
+    if (idx == mFiles.size() || mFiles.at(idx).fileName() != fileName) {
+        return -1;
+    }
+    return idx;
+}
+
+int BsaArchive::lowerBoundOfFile(const QString &fileName) const {
+    QByteArray name = fileName.toLatin1();
+    auto it = lower_bound(mFiles.begin(), mFiles.end(), name, [](const BsaFile &file, const QByteArray &searched) {
+        return qstrncmp(file.rawFileName(), searched.constData(), 14) < 0;
+    });
+    return int(it - mFiles.begin());
+}
+
+BsaFile BsaArchive::createNewBsaFile(const QString &filePath) {
+    QFileInfo newFileInfo(filePath);
+    // New file should exist and be readable for size
+    if (!newFileInfo.isFile() || !newFileInfo.isReadable()) {
+        throw Status(-1, QString("The file %1 doesn't exist or is not readable").arg(filePath));
+    }
+    BsaFile newBsaFile(static_cast<quint32>(newFileInfo.size()), 2, newFileInfo.fileName().toUpper());
+    newBsaFile.setIsNew(true);
+    return newBsaFile;
+}
+
+BsaFile BsaArchive::mergeUpdate(const BsaFile &internFile, const BsaFile &newBsaFile) {
+    // updating an already new file
+    if (internFile.isNew()) {
+        return newBsaFile;
+    }
+    // updating normal file
+    BsaFile updatedFile(internFile);
+    updatedFile.setUpdated(true);
+    updatedFile.setUpdateFileSize(newBsaFile.size());
+    return updatedFile;
+}
+
+void BsaArchive::readArchiveData(qint64 offset, char *destination, qint64 size) {
+    QFile *readHandle = acquireReadHandle();
+    qint64 bytesRead = -1;
+    if (readHandle->seek(offset)) {
+        bytesRead = readHandle->read(destination, size);
+    }
+    releaseReadHandle(readHandle);
+    if (bytesRead == -1) {
+        throw Status(-1, QStringLiteral("The file data is unreadable"));
+    }
+    if (bytesRead != size) {
+        throw Status(-1, QString("Could not retrieve all the data got %1, expected %2")
+                .arg(bytesRead).arg(size));
+    }
+}
+
+QFile *BsaArchive::acquireReadHandle() {
+    {
+        QMutexLocker locker(&mReadHandlesMutex);
+        if (!mReadHandles.isEmpty()) {
+            return mReadHandles.takeLast();
+        }
+    }
+    auto *readHandle = new QFile(mArchiveFile.fileName());
+    if (!readHandle->open(QIODevice::ReadOnly | QIODevice::Unbuffered)) {
+        delete readHandle;
+        throw Status(-1, QString("Could not open the file in read mode : %1")
+                .arg(mArchiveFile.fileName()));
+    }
+    return readHandle;
+}
+
+void BsaArchive::releaseReadHandle(QFile *readHandle) {
+    QMutexLocker locker(&mReadHandlesMutex);
+    mReadHandles.append(readHandle);
+}
+
+void BsaArchive::closeReadHandles() {
+    QMutexLocker locker(&mReadHandlesMutex);
+    qDeleteAll(mReadHandles);
+    mReadHandles.clear();
+}
@@ -2,10 +2,15 @@
 #define BSATOOL_ARCHIVE_H
 
 #include <bsa/BsaFile.h>
+#include <bsa/FileListDelta.h>
 #include <error/Status.h>
+#include <utils/DataView.h>
 #include <QVector>
 #include <QDataStream>
 #include <QFile>
+#include <QHash>
+#include <QAtomicInt>
+#include <QMutex>
 #include <QObject>
 
 /**
@@ -19,6 +24,9 @@
  *   - 4 bytes for the file size (max file size: 4 294 967 295 bytes)
  *
  * Datas are written in little endian
+ *
+ * Reading the files data (getFileData, getFileView, getFilesData) is thread-safe as long as the archive is not
+ * opened, closed, saved or modified at the same time
  */
 class BsaArchive: public QObject
 {
@@ -42,12 +50,26 @@ signals:
      */
     void fileListModified(QVector<BsaFile> fileList);
 
+    /**
+     * @brief signal sent when files are added, deleted, updated or reverted, describing only the change. It is not
+     * sent when the whole list is replaced (opening, closing, saving): fileListModified is then sent alone
+     * @param delta indexes of the inserted, removed and modified files;
+     */
+    void fileListChanged(FileListDelta delta);
+
     /**
      * @brief signal sent when a file in the archive is modified
      * @param file updated file;
      */
     void fileModified(BsaFile file);
 
+    /**
+     * @brief signal sent while extracting files, each time a file is done, successfully or not
+     * @param extractedNumber number of files done
+     * @param totalNumber number of files to extract
+     */
+    void extractionProgress(int extractedNumber, int totalNumber);
+
 public:
     //**************************************************************************
     // Statics
@@ -58,6 +80,40 @@ public:
      */
     const static int FILETABLE_ENTRY_SIZE = 18;
 
+    /**
+     * @brief Size of the buffer used to copy files data while saving: 1 MiB
+     */
+    const static int COPY_BUFFER_SIZE = 1048576;
+
+    /**
+     * @brief Extension added to the archive path for the journal of an incremental save
+     */
+    const static QString JOURNAL_EXT;
+
+    /**
+     * @brief Size of the journal header: 8 bytes for the unchanged data end, 2 for the file number and 8 for the
+     * size of the data following the header
+     */
+    const static int JOURNAL_HEADER_SIZE = 18;
+
+    //**************************************************************************
+    // Enumeration
+    //**************************************************************************
+    /**
+     * @brief options used when opening an archive
+     * - MEMORY_MAPPED: the whole archive is mapped in memory. Files data can then be accessed without copy through
+     * getFileView and getFileData only copies from the mapping
+     * - LAZY_FILE_TABLE: only the archive size is checked when opening. Files are looked up by name in the raw file
+     * table, the files list is built on first enumeration (getFiles, extractAll) or modification. fileListModified is
+     * not sent on opening
+     */
+    enum OpenFlag {
+        NO_OPEN_FLAG = 0x0,
+        MEMORY_MAPPED = 0x1,
+        LAZY_FILE_TABLE = 0x2
+    };
+    Q_DECLARE_FLAGS(OpenFlags, OpenFlag)
+
     //**************************************************************************
     // Constructors/Destructor
     //**************************************************************************
@@ -80,23 +136,50 @@ public:
 
     [[nodiscard]]QVector<BsaFile> getFiles() const;
 
+    /**
+     * @brief the files of the archive sorted by name, without copy. The reference stays valid until the archive is
+     * modified, saved or closed
+     */
+    [[nodiscard]]const QVector<BsaFile> &files() const;
+
     [[nodiscard]]bool isOpened() const;
 
+    [[nodiscard]]bool isMemoryMapped() const;
+
     [[nodiscard]]bool isModified() const;
 
+    /**
+     * @brief total size of the files data, taking the updated files sizes into account. Kept up to date by the
+     * modifications, so it does not go through the files
+     */
     [[nodiscard]]qint64 size() const;
 
     [[nodiscard]]quint16 fileNumber() const;
 
+    /**
+     * @brief retrieve a file of the archive from its name
+     * @param fileName name of the file
+     * @return the file or BsaFile::INVALID_BSAFILE if the archive is not opened or the file is not in it
+     */
+    [[nodiscard]]BsaFile getFile(const QString &fileName) const;
+
+    /**
+     * @brief retrieve the path of the external file holding the data of a new or updated file
+     * @param file the file
+     * @return the path to the external file, an empty string if the file is not new nor updated
+     */
+    [[nodiscard]]QString getModifiedFilePath(const BsaFile &file) const;
+
     //**************************************************************************
     // Methods
     //**************************************************************************
     /**
      * @brief open the given archive
      * @param filePath the filepath to the archive
-     * @throw status if the archive is already opened, source is unreadable or corrupted
+     * @param openFlags options to use while the archive is opened
+     * @throw status if the archive is already opened, source is unreadable, cannot be mapped or is corrupted
      */
-    void openArchive(const QString &filePath);
+    void openArchive(const QString &filePath, OpenFlags openFlags = NO_OPEN_FLAG);
 
     /**
      * @brief close this archive and restore state to a not opened archive
@@ -112,6 +195,22 @@ public:
      */
     QVector<char> getFileData(const BsaFile &file);
 
+    /**
+     * @brief retrieve the data of the given files, reading them concurrently on the global thread pool
+     * @param files the files to read
+     * @return the files data, in the same order than the given files
+     * @throw Status if a file is not in the archive or is (partially or fully) unreadable
+     */
+    QVector<QVector<char>> getFilesData(const QVector<BsaFile> &files);
+
+    /**
+     * @brief retrieve a read-only view on the data of the given file, without any copy. The view is only valid while
+     * the archive stays opened and not saved
+     * @param file the file to read
+     * @return the view on the file data in the memory mapped archive
+     * @throw Status if the archive is not memory mapped, the file is not in the archive or is new or updated
+     */
+    DataView getFileView(const BsaFile &file);
 
     /**
      * @brief extract a file (the external file data in case of an updated or new file)
@@ -121,6 +220,26 @@ public:
      */
     void extractFile(const QString &destinationFolder, const BsaFile &file);
 
+    /**
+     * @brief extract files (the external file data in case of an updated or new file). Files are read in their
+     * archive order and written in parallel on the global thread pool. A failure on a file does not stop the others.
+     * extractionProgress is sent each time a file is done
+     * @param destinationFolder destination folder of the files
+     * @param files files to extract
+     * @return the extraction status of each file, in the same order than the given files. A code of 0 indicates a
+     * success, -1 a failure detailed by the message
+     * @throw Status if the archive is not opened
+     */
+    QVector<Status> extractFiles(const QString &destinationFolder, const QVector<BsaFile> &files);
+
+    /**
+     * @brief extract all the files of the archive. See extractFiles
+     * @param destinationFolder destination folder of the files
+     * @return the extraction status of each file, in the same order than the archive files
+     * @throw Status if the archive is not opened
+     */
+    QVector<Status> extractAll(const QString &destinationFolder);
+
     /**
      * @brief delete a file
      * @param file file to delete
@@ -137,6 +256,16 @@ public:
      */
     BsaFile addOrUpdateFile(const QString &filePath);
 
+    /**
+     * @brief add to (update existing files of) the archive all the given files at once. Nothing is changed if one of
+     * the file is invalid. fileListChanged is sent once with the added and updated files indexes, fileListModified once
+     * if files are added and fileModified for each updated file
+     * @param filePaths paths of the new (updated) files. If several paths have the same filename, the last one is used
+     * @return the files created (updated), sorted by name
+     * @throw Status if a filepath cannot be read or a filename is longer than 13 characters
+     */
+    QVector<BsaFile> addOrUpdateFiles(const QStringList &filePaths);
+
     /**
      * @brief cancel the update operation pending on a file. Nothing is done if the file is not new or updated.
      * A new file will be deleted
@@ -153,12 +282,22 @@ public:
     void createNewArchive();
 
     /**
-     * @brief save the archive to the given file path
+     * @brief save the archive to the given file path. The archive then works on the saved file: the files offsets
+     * are updated from the written data without reading the saved archive, and fileListModified is emitted once
      * @param filePath path to the save file
      * @throw status if failure to save data or archive closed
      */
     void saveArchive(const QString &filePath);
 
+    /**
+     * @brief save the archive in place, rewriting only the data following the first updated or deleted file, plus
+     * the file table. New files are written at the end. The rewritten part is first written to a journal next to the
+     * archive, so that an interrupted save is finished on next opening. The files offsets are updated without reading
+     * the archive again
+     * @throw status if failure to save data, archive closed or never saved
+     */
+    void saveArchiveIncrementally();
+
 private:
     //**************************************************************************
     // Attributes
@@ -174,9 +313,55 @@ private:
     QFile mArchiveFile{};
 
     /**
-     * @brief List of the archive files
+     * @brief options used to open the archive
+     */
+    OpenFlags mOpenFlags{NO_OPEN_FLAG};
+
+    /**
+     * @brief start of the archive data in memory if memory mapped, nullptr otherwise
+     */
+    uchar *mMappedData{nullptr};
+
+    /**
+     * @brief List of the archive files, built on first use when opened with LAZY_FILE_TABLE
      */
-    QVector<BsaFile> mFiles{};
+    mutable QVector<BsaFile> mFiles{};
+
+    /**
+     * @brief path of the external file of each new or updated file, by file name
+     */
+    QHash<QString, QString> mModifiedFilePaths{};
+
+    /**
+     * @brief file table as stored in the archive, kept while the files list is not built. Read under mFilesMutex, since
+     * it is released once the files list is built
+     */
+    mutable QByteArray mRawFileTable{};
+
+    /**
+     * @brief start offset in archive of each record of the raw file table
+     */
+    mutable QVector<qint64> mRawOffsets{};
+
+    /**
+     * @brief records of the raw file table sorted by name
+     */
+    mutable QVector<quint16> mRawIndex{};
+
+    /**
+     * @brief 1 while the files list has not been built from the raw file table
+     */
+    mutable QAtomicInt mFilesPending{0};
+
+    /**
+     * @brief mutex protecting the files list building
+     */
+    mutable QMutex mFilesMutex{};
+
+    /**
+     * @brief total size of the files data
+     */
+    qint64 mTotalSize{0};
 
     /**
      * @brief Original file number when opened
@@ -184,9 +369,14 @@ private:
     quint16 mOriginalFileNumber{0};
 
     /**
-     * @brief file stream reading the archive file
+     * @brief read only handles on the archive file, each one used by a single reading thread at a time
+     */
+    QVector<QFile *> mReadHandles{};
+
+    /**
+     * @brief mutex protecting the read handles list
      */
-    QDataStream mReadingStream{};
+    QMutex mReadHandlesMutex{};
 
     //**************************************************************************
     // Methods
@@ -198,6 +388,161 @@ private:
      * @throw status if the archive is not opened or the file is not in it
      */
     int verifyArchiveOpenAndFileExists(const BsaFile &file);
+
+    /**
+     * @brief check and throw error if file is not in the archive or the archive is not opened. Does not need the
+     * files list to be built
+     * @param file the file to check
+     * @return the archive version of the file
+     * @throw status if the archive is not opened or the file is not in it
+     */
+    BsaFile verifyArchiveOpenAndGetFile(const BsaFile &file) const;
+
+    /**
+     * @brief search a file in the list of the archive files, using a binary search since the list is sorted by name
+     * @param fileName name of the file
+     * @return the index of the file in the list or -1 if not found
+     */
+    [[nodiscard]]int indexOfFile(const QString &fileName) const;
+
+    /**
+     * @brief search the first file of the list which name is not lower than the given one
+     * @param fileName name of the file
+     * @return the index of this file in the list, or the list size if all names are lower
+     */
+    [[nodiscard]]int lowerBoundOfFile(const QString &fileName) const;
+
+    /**
+     * @brief build the archive file describing a new external file
+     * @param filePath path to the new file
+     * @return the new file
+     * @throw Status if the filepath cannot be read or the filename is longer than 13 characters
+     */
+    static BsaFile createNewBsaFile(const QString &filePath);
+
+    /**
+     * @brief apply an update to an archive file
+     * @param internFile the file in the archive
+     * @param newBsaFile the new file updating it, with the same name
+     * @return the new file if the archive file was also new, the archive file updated otherwise
+     */
+    static BsaFile mergeUpdate(const BsaFile &internFile, const BsaFile &newBsaFile);
+
+    /**
+     * @brief read data from the archive file using a read handle not shared with other threads
+     * @param offset offset in the archive of the data to read
+     * @param destination buffer receiving the data
+     * @param size number of bytes to read
+     * @throw status if the data cannot be fully read
+     */
+    void readArchiveData(qint64 offset, char *destination, qint64 size);
+
+    /**
+     * @brief take a free read handle on the archive file, opening a new one if none is available
+     * @return the read handle, to give back with releaseReadHandle
+     * @throw status if a new handle cannot be opened
+     */
+    QFile *acquireReadHandle();
+
+    /**
+     * @brief give back a read handle taken with acquireReadHandle
+     * @param readHandle the handle to give back
+     */
+    void releaseReadHandle(QFile *readHandle);
+
+    /**
+     * @brief close and delete all the read handles. No read should be running
+     */
+    void closeReadHandles();
+
+    /**
+     * @brief write the data of a file at the current position of the destination, without loading it entirely in
+     * memory. Unchanged files of a memory mapped archive are written straight from the mapping
+     * @param destination the device to write to
+     * @param file the file which data is written
+     * @param buffer buffer used to copy the data chunk by chunk
+     * @throw status if the data cannot be fully read or written
+     */
+    void writeFileData(QFile &destination, const BsaFile &file, QVector<char> &buffer);
+
+    /**
+     * @brief build the file table describing the given files, in the given order
+     * @param files the files to describe
+     * @return the file table data
+     */
+    static QByteArray buildFileTable(const QVector<BsaFile> &files);
+
+    /**
+     * @brief read the file number and the whole file table of the opened archive file in a single read, and compute
+     * the files offsets
+     * @throw status if the archive is unreadable or corrupted
+     */
+    void readFileTable();
+
+    /**
+     * @brief sort the raw file table records by name and mark the files list as not built
+     */
+    void buildRawIndex();
+
+    /**
+     * @brief fill the files list from the raw file table
+     */
+    void buildFilesFromRawTable() const;
+
+    /**
+     * @brief build the files list if it is not built yet. Safe to call from several threads
+     */
+    void loadFiles() const;
+
+    /**
+     * @brief release the raw file table
+     */
+    void clearRawFileTable() const;
+
+    /**
+     * @brief create the file described by a record of the raw file table
+     * @param record index of the record in the raw file table
+     * @return the file
+     */
+    [[nodiscard]]BsaFile rawRecordFile(int record) const;
+
+    /**
+     * @brief search a file by name in the raw file table
+     * @param fileName name of the file
+     * @return the index of the record in the raw file table, -1 if not found
+     */
+    [[nodiscard]]int rawRecordOfFile(const QString &fileName) const;
+
+    /**
+     * @brief write the journal content to the archive then remove the journal. An incomplete journal is only removed
+     * since the archive has not been touched yet
+     * @param filePath path to the archive
+     * @throw status if the archive cannot be written
+     */
+    static void applyJournal(const QString &filePath);
+
+    /**
+     * @brief rebuild the files list from the files just saved and open the saved archive file
+     * @param filePath path to the saved archive
+     * @param layout the saved files in the order of their data in the archive, in their state before the save
+     * @throw status if the saved archive cannot be opened
+     */
+    void reloadFromLayout(const QString &filePath, const QVector<BsaFile> &layout);
+
+    /**
+     * @brief open (and map if asked) the archive file
+     * @param filePath path to the archive
+     * @param openFlags options to use while the archive is opened
+     * @throw status if the file cannot be opened or mapped
+     */
+    void openArchiveFile(const QString &filePath, OpenFlags openFlags);
+
+    /**
+     * @brief unmap and close the archive file and all the read handles
+     */
+    void closeArchiveFile();
 };
 
+Q_DECLARE_OPERATORS_FOR_FLAGS(BsaArchive::OpenFlags)
+
 #endif // BSATOOL_ARCHIVE_H
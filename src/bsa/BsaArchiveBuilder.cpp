@@ -0,0 +1,283 @@
+#include <bsa/BsaArchiveBuilder.h>
+#include <bsa/BsaArchive.h>
+#include <assets/FileType.h>
+#include <assets/Img.h>
+#include <error/Status.h>
+#include <QDirIterator>
+#include <utils/ConcurrentUtils.h>
+#include <QFileInfo>
+#include <QtEndian>
+#include <limits>
+#include <numeric>
+
+//******************************************************************************
+// Getters/setters
+//******************************************************************************
+const QStringList &BsaArchiveBuilder::filePaths() const {
+    return mFilePaths;
+}
+
+bool BsaArchiveBuilder::imgRecompression() const {
+    return mImgRecompression;
+}
+
+void BsaArchiveBuilder::setImgRecompression(bool imgRecompression) {
+    mImgRecompression = imgRecompression;
+}
+
+const QVector<BsaArchiveBuilder::ImgRecompression> &BsaArchiveBuilder::imgRecompressionReport() const {
+    return mImgRecompressionReport;
+}
+
+//******************************************************************************
+// Methods
+//******************************************************************************
+void BsaArchiveBuilder::addFile(const QString &filePath) {
+    mFilePaths.append(filePath);
+}
+
+void BsaArchiveBuilder::addFiles(const QStringList &filePaths) {
+    mFilePaths.append(filePaths);
+}
+
+void BsaArchiveBuilder::addDirectory(const QString &directoryPath) {
+    if (!QFileInfo(directoryPath).isDir()) {
+        throw Status(-1, QString("The directory %1 doesn't exist").arg(directoryPath));
+    }
+    QDirIterator it(directoryPath, QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        mFilePaths.append(it.next());
+    }
+}
+
+void BsaArchiveBuilder::clear() {
+    mFilePaths.clear();
+}
+
+QVector<BsaFile> BsaArchiveBuilder::build(const QString &archivePath, const ArchiveConfiguration &configuration) {
+    QVector<int> fileOrder;
+    QVector<BsaFile> files = validateFiles(fileOrder);
+    mImgRecompressionReport.clear();
+    QHash<int, QVector<char>> recompressedData;
+    if (mImgRecompression) {
+        recompressedData = recompressImgFiles(files, fileOrder, configuration);
+    }
+    QFile archiveFile(archivePath + ".tmp");
+    if (!archiveFile.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Unbuffered)) {
+        throw Status(-1, QString("Cannot build archive: could not write temporary file %1")
+                .arg(archiveFile.fileName()));
+    }
+    try {
+        writeArchive(archiveFile, files, fileOrder, recompressedData);
+    } catch (Status &e) {
+        archiveFile.close();
+        archiveFile.remove();
+        throw Status(-1, "Unable to build archive : " + e.message());
+    }
+    archiveFile.close();
+    // Replacing the existing archive if any
+    if (QFile::exists(archivePath) && !QFile::remove(archivePath)) {
+        throw Status(-1, QString("Could not delete existing file %1. Built archive can be found at %2")
+                .arg(archivePath, archiveFile.fileName()));
+    }
+    if (!archiveFile.rename(archivePath)) {
+        throw Status(-1, QString("Could not rename built archive %1 to %2. Built archive can be found at %1")
+                .arg(archiveFile.fileName(), archivePath));
+    }
+    return files;
+}
+
+QVector<BsaFile> BsaArchiveBuilder::validateFiles(QVector<int> &fileOrder) const {
+    QStringList errors;
+    QVector<BsaFile> files;
+    files.reserve(mFilePaths.size());
+    fileOrder.clear();
+    fileOrder.reserve(mFilePaths.size());
+    for (int i(0); i < mFilePaths.size(); i++) {
+        const QString &filePath = mFilePaths.at(i);
+        QFileInfo fileInfo(filePath);
+        QString fileName = fileInfo.fileName().toUpper();
+        if (!fileInfo.isFile() || !fileInfo.isReadable()) {
+            errors.append(QString("%1 : the file doesn't exist or is not readable").arg(filePath));
+            continue;
+        }
+        if (fileName.size() > 13) {
+            errors.append(QString("%1 : the name is too long (maximum allowed : 13 characters)").arg(filePath));
+            continue;
+        }
+        if (any_of(fileName.begin(), fileName.end(), [](QChar c) { return c.unicode() < 0x20 || c.unicode() > 0x7E; })) {
+            errors.append(QString("%1 : the name contains non ascii characters").arg(filePath));
+            continue;
+        }
+        if (fileInfo.size() > std::numeric_limits<quint32>::max()) {
+            errors.append(QString("%1 : the file is too large").arg(filePath));
+            continue;
+        }
+        files.append(BsaFile(quint32(fileInfo.size()), 2, fileName));
+        fileOrder.append(i);
+    }
+    // Archive order: by name
+    QVector<int> nameOrder(files.size());
+    iota(nameOrder.begin(), nameOrder.end(), 0);
+    stable_sort(nameOrder.begin(), nameOrder.end(), [&files](int first, int second) {
+        return files.at(first) < files.at(second);
+    });
+    for (int i(1); i < nameOrder.size(); i++) {
+        if (files.at(nameOrder.at(i)) == files.at(nameOrder.at(i - 1))) {
+            errors.append(QString("%1 : the name %2 is already used by %3")
+                                  .arg(mFilePaths.at(fileOrder.at(nameOrder.at(i))),
+                                       files.at(nameOrder.at(i)).fileName(),
+                                       mFilePaths.at(fileOrder.at(nameOrder.at(i - 1)))));
+        }
+    }
+    if (files.size() > MAX_FILE_NUMBER) {
+        errors.append(QString("Too many files : %1 (maximum allowed : %2)").arg(files.size()).arg(MAX_FILE_NUMBER));
+    }
+    // Placing the files one after the other
+    QVector<BsaFile> sortedFiles;
+    QVector<int> sortedOrder;
+    sortedFiles.reserve(files.size());
+    sortedOrder.reserve(files.size());
+    qint64 offset(2);
+    for (int idx : qAsConst(nameOrder)) {
+        if (offset > std::numeric_limits<quint32>::max()) {
+            errors.append(QStringLiteral("The archive is too large (maximum allowed : 4 GiB)"));
+            break;
+        }
+        sortedFiles.append(BsaFile(files.at(idx).size(), offset, files.at(idx).rawFileName()));
+        sortedOrder.append(fileOrder.at(idx));
+        offset += files.at(idx).size();
+    }
+    if (!errors.isEmpty()) {
+        throw Status(-1, QString("Cannot build archive: %1 invalid file(s) :\n%2")
+                .arg(errors.size()).arg(errors.join('\n')));
+    }
+    fileOrder = sortedOrder;
+    return sortedFiles;
+}
+
+QHash<int, QVector<char>> BsaArchiveBuilder::recompressImgFiles(QVector<BsaFile> &files,
+                                                                 const QVector<int> &fileOrder,
+                                                                 const ArchiveConfiguration &configuration) {
+    QVector<int> imgIndexes;
+    for (int i(0); i < files.size(); i++) {
+        const BsaFile &file = files.at(i);
+        // The data of an IMG without header could be mistaken for a header
+        bool noHeader = configuration.hasConfigurationForFile(file) &&
+                        configuration.getConfigurationForFile(file).isNoHeader();
+        if (FileType::getExtension(file) == FileType::IMG && !noHeader) {
+            imgIndexes.append(i);
+        }
+    }
+    // Data to store, with true if the file was loaded as an IMG
+    auto recompressImg = [&](int index) {
+        QFile source(mFilePaths.at(fileOrder.at(index)));
+        if (!source.open(QIODevice::ReadOnly)) {
+            throw Status(-1, QStringLiteral("Could not open the file in read mode"));
+        }
+        QByteArray content = source.readAll();
+        QVector<char> data(content.constBegin(), content.constEnd());
+        // Without configuration, raw pixels could still be mistaken for a header
+        if (!Img::hasMatchingHeader(data)) {
+            return qMakePair(false, data);
+        }
+        try {
+            return qMakePair(true, Img::recompress(data));
+        } catch (Status &) {
+            // Not a valid IMG with header: stored as is
+            return qMakePair(false, data);
+        }
+    };
+    QVector<QPair<bool, QVector<char>>> imgData = ConcurrentUtils::blockingMapped<QPair<bool, QVector<char>>>(
+            imgIndexes, recompressImg, [&](int index) { return mFilePaths.at(fileOrder.at(index)); },
+            QStringLiteral("Unable to recompress IMG files"));
+    QHash<int, QVector<char>> recompressedData;
+    mImgRecompressionReport.reserve(imgIndexes.size());
+    for (int i(0); i < imgIndexes.size(); i++) {
+        const BsaFile &file = files.at(imgIndexes.at(i));
+        const QVector<char> &data = imgData.at(i).second;
+        ImgRecompression result;
+        result.fileName = file.fileName();
+        result.originalSize = file.size();
+        result.recompressedSize = file.size();
+        if (imgData.at(i).first) {
+            result.compressionFlag = quint8(data.at(8));
+        }
+        if (data.size() < file.size()) {
+            result.recompressedSize = data.size();
+            recompressedData.insert(fileOrder.at(imgIndexes.at(i)), data);
+        }
+        mImgRecompressionReport.append(result);
+    }
+    // Placing again the files one after the other
+    qint64 offset(2);
+    for (int i(0); i < files.size(); i++) {
+        auto data = recompressedData.constFind(fileOrder.at(i));
+        quint32 size = data != recompressedData.constEnd() ? quint32(data.value().size()) : files.at(i).size();
+        files[i] = BsaFile(size, offset, files.at(i).rawFileName());
+        offset += size;
+    }
+    return recompressedData;
+}
+
+void BsaArchiveBuilder::writeArchive(QFile &archiveFile, const QVector<BsaFile> &files, const QVector<int> &fileOrder,
+                                     const QHash<int, QVector<char>> &recompressedData) const {
+    // Data gathered in a large buffer to write the archive sequentially in large blocks
+    QVector<char> buffer(WRITE_BUFFER_SIZE);
+    int bufferedBytes(0);
+    auto flush = [&]() {
+        if (archiveFile.write(buffer.constData(), bufferedBytes) != bufferedBytes) {
+            throw Status(-1, QStringLiteral("Error while writing the archive data"));
+        }
+        bufferedBytes = 0;
+    };
+    // Header
+    qToLittleEndian(quint16(files.size()), buffer.data());
+    bufferedBytes += 2;
+    // Files data
+    for (int i(0); i < files.size(); i++) {
+        auto data = recompressedData.constFind(fileOrder.at(i));
+        if (data != recompressedData.constEnd()) {
+            qint64 writtenBytes(0);
+            while (writtenBytes < data.value().size()) {
+                if (bufferedBytes == buffer.size()) {
+                    flush();
+                }
+                int chunkSize = int(qMin(qint64(data.value().size() - writtenBytes),
+                                         qint64(buffer.size() - bufferedBytes)));
+                memcpy(buffer.data() + bufferedBytes, data.value().constData() + writtenBytes, size_t(chunkSize));
+                bufferedBytes += chunkSize;
+                writtenBytes += chunkSize;
+            }
+            continue;
+        }
+        QFile source(mFilePaths.at(fileOrder.at(i)));
+        if (!source.open(QIODevice::ReadOnly | QIODevice::Unbuffered)) {
+            throw Status(-1, QString("Could not open the file in read mode : %1").arg(source.fileName()));
+        }
+        qint64 remainingBytes = files.at(i).size();
+        while (remainingBytes > 0) {
+            if (bufferedBytes == buffer.size()) {
+                flush();
+            }
+            qint64 chunkSize = qMin(remainingBytes, qint64(buffer.size() - bufferedBytes));
+            if (source.read(buffer.data() + bufferedBytes, chunkSize) != chunkSize) {
+                throw Status(-1, QString("Could not read all the data of %1: the file changed")
+                        .arg(source.fileName()));
+            }
+            bufferedBytes += int(chunkSize);
+            remainingBytes -= chunkSize;
+        }
+    }
+    // File table
+    for (const auto &file : files) {
+        if (buffer.size() - bufferedBytes < BsaArchive::FILETABLE_ENTRY_SIZE) {
+            flush();
+        }
+        char *entry = buffer.data() + bufferedBytes;
+        memcpy(entry, file.rawFileName(), 14);
+        qToLittleEndian(file.size(), entry + 14);
+        bufferedBytes += BsaArchive::FILETABLE_ENTRY_SIZE;
+    }
+    flush();
+}
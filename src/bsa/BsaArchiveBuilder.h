@@ -0,0 +1,188 @@
+#ifndef BSATOOL_BSAARCHIVEBUILDER_H
+#define BSATOOL_BSAARCHIVEBUILDER_H
+
+#include <bsa/BsaFile.h>
+#include <configuration/ArchiveConfiguration.h>
+#include <QFile>
+#include <QHash>
+#include <QStringList>
+#include <QVector>
+
+/**
+ * @brief Build a new BSA archive from files on disk in a single pass
+ *
+ * The files are only listed until build is called. build then checks all of them at once and streams their content
+ * to the archive through a large buffer, so that the archive is written with large sequential writes, and finally
+ * writes the file table. Files are stored in name order, as BsaArchive does
+ *
+ * Optionally, the IMG files can be recompressed on the fly with the compression giving the smallest file (see
+ * Img::recompress). The files are then recompressed in parallel before the archive is written. The IMG files without
+ * header in the archive configuration, and the ones whose header does not describe exactly their size, are stored as
+ * is
+ */
+class BsaArchiveBuilder {
+public:
+    /**
+     * @brief Result of the recompression of an IMG file
+     */
+    struct ImgRecompression {
+        /**
+         * @brief name of the file in the archive
+         */
+        QString fileName{};
+        /**
+         * @brief size of the file on disk
+         */
+        qint64 originalSize{0};
+        /**
+         * @brief size of the file in the archive
+         */
+        qint64 recompressedSize{0};
+        /**
+         * @brief compression flag of the file in the archive, 0 if the file could not be loaded as an IMG
+         */
+        quint8 compressionFlag{0};
+
+        /**
+         * @brief number of bytes saved by the recompression
+         */
+        [[nodiscard]] qint64 savedSize() const {
+            return originalSize - recompressedSize;
+        }
+    };
+
+    //**************************************************************************
+    // Statics
+    //**************************************************************************
+    /**
+     * @brief Maximum number of files in an archive
+     */
+    const static int MAX_FILE_NUMBER = 65535;
+
+    /**
+     * @brief Size of the buffer gathering the data before writing it: 4 MiB
+     */
+    const static int WRITE_BUFFER_SIZE = 4194304;
+
+    //**************************************************************************
+    // Constructors
+    //**************************************************************************
+    /**
+     * @brief constructor of a builder without file
+     */
+    BsaArchiveBuilder() = default;
+
+    //**************************************************************************
+    // Getters/setters
+    //**************************************************************************
+    /**
+     * @brief paths of the files to put in the archive
+     */
+    [[nodiscard]]const QStringList &filePaths() const;
+    /**
+     * @brief true if the IMG files are recompressed when building the archive. Disabled by default
+     */
+    [[nodiscard]] bool imgRecompression() const;
+    /**
+     * @brief enable or disable the recompression of the IMG files when building the archive
+     */
+    void setImgRecompression(bool imgRecompression);
+    /**
+     * @brief result of the recompression of each IMG file with header during the last build, in archive order. Empty
+     * if the recompression is disabled
+     */
+    [[nodiscard]] const QVector<ImgRecompression> &imgRecompressionReport() const;
+
+    //**************************************************************************
+    // Methods
+    //**************************************************************************
+    /**
+     * @brief add a file to the archive. Its name in the archive is its file name in upper case
+     * @param filePath path to the file
+     */
+    void addFile(const QString &filePath);
+
+    /**
+     * @brief add files to the archive. See addFile
+     * @param filePaths paths to the files
+     */
+    void addFiles(const QStringList &filePaths);
+
+    /**
+     * @brief add all the files of a directory and its sub directories to the archive. See addFile
+     * @param directoryPath path to the directory
+     * @throw Status if the directory does not exist
+     */
+    void addDirectory(const QString &directoryPath);
+
+    /**
+     * @brief remove all the files from the builder
+     */
+    void clear();
+
+    /**
+     * @brief check all the files then write the archive. The archive is first written to a temporary file which
+     * replaces the given path once complete
+     * @param archivePath path to the archive to write
+     * @param configuration configuration of the archive, telling which IMG files have no header
+     * @return the files of the written archive, sorted by name
+     * @throw Status listing all the invalid files (unreadable, name longer than 13 characters or not ascii, name used
+     * twice, too many files, archive too large) or if the archive cannot be written
+     */
+    QVector<BsaFile> build(const QString &archivePath,
+                           const ArchiveConfiguration &configuration = ArchiveConfiguration());
+
+private:
+    //**************************************************************************
+    // Attributes
+    //**************************************************************************
+    /**
+     * @brief paths of the files to put in the archive
+     */
+    QStringList mFilePaths{};
+    /**
+     * @brief true if the IMG files are recompressed when building the archive
+     */
+    bool mImgRecompression{false};
+    /**
+     * @brief result of the recompression of each IMG file during the last build
+     */
+    QVector<ImgRecompression> mImgRecompressionReport{};
+
+    //**************************************************************************
+    // Methods
+    //**************************************************************************
+    /**
+     * @brief check all the files and compute their place in the archive
+     * @param fileOrder receives the indexes in mFilePaths of the files, in archive order
+     * @return the archive files, sorted by name
+     * @throw Status listing all the invalid files
+     */
+    QVector<BsaFile> validateFiles(QVector<int> &fileOrder) const;
+
+    /**
+     * @brief recompress in parallel the IMG files, then update the size and the place in the archive of the files
+     * which got smaller. The IMG files without header in the configuration, the ones whose header does not describe
+     * exactly their size and the ones which cannot be loaded are kept as is
+     * @param files the archive files, in archive order
+     * @param fileOrder the indexes in mFilePaths of the files, in archive order
+     * @param configuration configuration of the archive, telling which IMG files have no header
+     * @return the recompressed data, by index in mFilePaths
+     * @throw Status if a file cannot be read
+     */
+    QHash<int, QVector<char>> recompressImgFiles(QVector<BsaFile> &files, const QVector<int> &fileOrder,
+                                                 const ArchiveConfiguration &configuration);
+
+    /**
+     * @brief write the archive header, the files data and the file table
+     * @param archiveFile the archive file, opened in write mode
+     * @param files the archive files, in archive order
+     * @param fileOrder the indexes in mFilePaths of the files, in archive order
+     * @param recompressedData data to write instead of the file content, by index in mFilePaths
+     * @throw Status if a file cannot be read or the archive cannot be written
+     */
+    void writeArchive(QFile &archiveFile, const QVector<BsaFile> &files, const QVector<int> &fileOrder,
+                      const QHash<int, QVector<char>> &recompressedData) const;
+};
+
+#endif // BSATOOL_BSAARCHIVEBUILDER_H
@@ -1,6 +1,10 @@
-#include <utility>
 #include <bsa/BsaFile.h>
 #include <error/Status.h>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+static_assert(std::is_trivially_copyable<BsaFile>::value, "BsaFile must stay trivially copyable");
 
 //******************************************************************************
 // Statics
@@ -11,18 +15,32 @@ const BsaFile BsaFile::INVALID_BSAFILE(0, 0, "INVALID"); // NOLINT(cert-err58-cp
 // Constructors
 //******************************************************************************
 
-BsaFile::BsaFile() :
-        mSize(BsaFile::INVALID_BSAFILE.size()), mStartOffsetInArchive(BsaFile::INVALID_BSAFILE.startOffsetInArchive()),
-        mFileName(BsaFile::INVALID_BSAFILE.fileName()) {
+BsaFile::BsaFile() : BsaFile(BsaFile::INVALID_BSAFILE) {
 }
 
 BsaFile::BsaFile(quint32 size,
                  qint64 startOffsetInArchive,
-                 QString fileName) :
-        mSize(size), mStartOffsetInArchive(startOffsetInArchive), mFileName(std::move(fileName)) {
-    if (mFileName.size() > 13) {
-        throw Status(-1, QString("The filename %1 is too long (maximum allowed : 13 characters").arg(mFileName));
+                 const QString &fileName) :
+        BsaFile(size, startOffsetInArchive, (fileName.size() > 13 ? QByteArray() : fileName.toLatin1()).constData()) {
+    if (fileName.size() > 13) {
+        throw Status(-1, QString("The filename %1 is too long (maximum allowed : 13 characters").arg(fileName));
+    }
+}
+
+BsaFile::BsaFile(quint32 size,
+                 qint64 startOffsetInArchive,
+                 const char *rawFileName) :
+        mSize(size), mStartOffsetInArchive(quint32(startOffsetInArchive)) {
+    size_t nameLength = qstrnlen(rawFileName, sizeof(mFileName));
+    if (nameLength > 13) {
+        throw Status(-1, QString("The filename %1 is too long (maximum allowed : 13 characters")
+                .arg(QString::fromLatin1(rawFileName, int(nameLength))));
+    }
+    if (startOffsetInArchive < 0 || startOffsetInArchive > std::numeric_limits<quint32>::max()) {
+        throw Status(-1, QString("The offset %1 of file %2 is out of the archive limits")
+                .arg(startOffsetInArchive).arg(QString::fromLatin1(rawFileName, int(nameLength))));
     }
+    memcpy(mFileName, rawFileName, nameLength);
 }
 
 //**************************************************************************
@@ -30,43 +48,48 @@ BsaFile::BsaFile(quint32 size,
 //**************************************************************************
 
 bool BsaFile::operator<(const BsaFile &bsaFile) const {
-    return mFileName < bsaFile.mFileName;
+    return memcmp(mFileName, bsaFile.mFileName, sizeof(mFileName)) < 0;
 }
 
 bool BsaFile::operator<=(const BsaFile &bsaFile) const {
-    return mFileName <= bsaFile.mFileName;
+    return memcmp(mFileName, bsaFile.mFileName, sizeof(mFileName)) <= 0;
 }
 
 bool BsaFile::operator>(const BsaFile &bsaFile) const {
-    return mFileName > bsaFile.mFileName;
+    return memcmp(mFileName, bsaFile.mFileName, sizeof(mFileName)) > 0;
 }
 
 bool BsaFile::operator>=(const BsaFile &bsaFile) const {
-    return mFileName >= bsaFile.mFileName;
+    return memcmp(mFileName, bsaFile.mFileName, sizeof(mFileName)) >= 0;
 }
 
 bool BsaFile::operator==(const BsaFile &bsaFile) const {
-    return mFileName == bsaFile.mFileName;
+    return memcmp(mFileName, bsaFile.mFileName, sizeof(mFileName)) == 0;
 }
 
 bool BsaFile::operator!=(const BsaFile &bsaFile) const {
-    return mFileName != bsaFile.mFileName;
+    return memcmp(mFileName, bsaFile.mFileName, sizeof(mFileName)) != 0;
 }
 
 //**************************************************************************
 // Methods
 //**************************************************************************
 QString BsaFile::getExtension() const {
-    int idx = mFileName.lastIndexOf('.');
-    if (idx == -1 || idx == mFileName.length()) {
+    QString fileName = this->fileName();
+    int idx = fileName.lastIndexOf('.');
+    if (idx == -1 || idx == fileName.length()) {
         return {};
     } else {
-        return mFileName.mid(idx + 1);
+        return fileName.mid(idx + 1);
     }
 }
 
 bool BsaFile::isValid() const {
-    return mStartOffsetInArchive >= 2 && !mFileName.isEmpty();
+    return mStartOffsetInArchive >= 2 && mFileName[0] != '\0';
+}
+
+quint32 BsaFile::dataSize() const {
+    return updated() ? mUpdateFileSize : mSize;
 }
 
 //******************************************************************************
@@ -81,23 +104,27 @@ qint64 BsaFile::startOffsetInArchive() const {
 }
 
 QString BsaFile::fileName() const {
+    return QString::fromLatin1(mFileName, int(qstrnlen(mFileName, sizeof(mFileName))));
+}
+
+const char *BsaFile::rawFileName() const {
     return mFileName;
 }
 
 bool BsaFile::isNew() const {
-    return mIsNew;
+    return mFlags & IS_NEW_FLAG;
 }
 
 void BsaFile::setIsNew(bool isNew) {
-    mIsNew = isNew;
+    mFlags = quint8(isNew ? mFlags | IS_NEW_FLAG : mFlags & ~IS_NEW_FLAG);
 }
 
 bool BsaFile::updated() const {
-    return mUpdated;
+    return mFlags & UPDATED_FLAG;
 }
 
 void BsaFile::setUpdated(bool updated) {
-    mUpdated = updated;
+    mFlags = quint8(updated ? mFlags | UPDATED_FLAG : mFlags & ~UPDATED_FLAG);
 }
 
 quint32 BsaFile::updateFileSize() const {
@@ -107,11 +134,3 @@ quint32 BsaFile::updateFileSize() const {
 void BsaFile::setUpdateFileSize(quint32 updateFileSize) {
     mUpdateFileSize = updateFileSize;
 }
-
-QString BsaFile::modifiedFilePath() const {
-    return mModifiedFilePath;
-}
-
-void BsaFile::setModifiedFilePath(const QString &modifiedFilePath) {
-    mModifiedFilePath = modifiedFilePath;
-}
\ No newline at end of file
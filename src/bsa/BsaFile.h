@@ -8,6 +8,9 @@
  *
  * Describe an archive file. A file with an offset of zero or one indicate an invalid
  * file since the minimum is 2 (bsa archive begins by two bytes for file number)
+ *
+ * The file is trivially copyable: the name is stored inline, zero padded as in the archive file table. The path to
+ * the data of a new or updated file is kept by the archive (see BsaArchive::getModifiedFilePath)
  */
 class BsaFile
 {
@@ -38,7 +41,17 @@ public:
      */
     BsaFile(quint32 size,
          qint64 startOffsetInArchive,
-         QString fileName);
+         const QString &fileName);
+    /**
+     * @brief File constructor from a raw latin1 name, as stored in the archive file table
+     * @param size the file size
+     * @param startOffsetInArchive offset at which the data of this file starts in the archive
+     * @param rawFileName the file name, zero terminated or 14 bytes long
+     * @throw Status if filename size is more than 13 characters
+     */
+    BsaFile(quint32 size,
+         qint64 startOffsetInArchive,
+         const char *rawFileName);
     /**
      * @brief copy constructor
      */
@@ -93,6 +106,12 @@ public:
      */
     [[nodiscard]]bool isValid() const;
 
+    /**
+     * @brief size of the data to store for this file
+     * @return the update file size if the file is updated, its size otherwise
+     */
+    [[nodiscard]]quint32 dataSize() const;
+
     //**************************************************************************
     // Getters/setters
     //**************************************************************************
@@ -108,6 +127,10 @@ public:
      * @brief file name
      */
     [[nodiscard]]QString fileName() const;
+    /**
+     * @brief file name as stored in the archive: 14 latin1 characters padded with zeros
+     */
+    [[nodiscard]]const char *rawFileName() const;
     /**
      * @brief true if the file is new and to add to the archive
      */
@@ -132,14 +155,6 @@ public:
      * @brief set the size of the update file
      */
     void setUpdateFileSize(quint32 updateFileSize);
-    /**
-     * @brief the complete path to the update or new file
-     */
-    [[nodiscard]]QString modifiedFilePath() const;
-    /**
-     * @brief set the complete path to the update or new file
-     */
-    void setModifiedFilePath(const QString &modifiedFilePath);
 
 private:
     //**************************************************************************
@@ -152,27 +167,30 @@ private:
     /**
      * @brief start offset of the file data in archive
      */
-    qint64 mStartOffsetInArchive{0};
+    quint32 mStartOffsetInArchive{0};
     /**
-     * @brief file name
+     * @brief the size of the update file
      */
-    QString mFileName{};
+    quint32 mUpdateFileSize{0};
     /**
-     * @brief true if the file is new and to add to the archive
+     * @brief file name, padded with zeros
      */
-    bool mIsNew{false};
+    char mFileName[14]{};
     /**
-     * @brief true if the file is to be updated with a new version
+     * @brief combination of the state flags
      */
-    bool mUpdated{false};
+    quint8 mFlags{0};
+
     /**
-     * @brief the size of the update file
+     * @brief flag set if the file is new and to add to the archive
      */
-    quint32 mUpdateFileSize{0};
+    const static quint8 IS_NEW_FLAG = 0x1;
     /**
-     * @brief the complete path to the update or new file
+     * @brief flag set if the file is to be updated with a new version
      */
-    QString mModifiedFilePath{};
+    const static quint8 UPDATED_FLAG = 0x2;
 };
 
+Q_DECLARE_TYPEINFO(BsaFile, Q_MOVABLE_TYPE);
+
 #endif // BSATOOL_FILE_H
@@ -0,0 +1,134 @@
+#include <bsa/DecodeCache.h>
+#include <error/Status.h>
+#include <utils/HashUtils.h>
+
+//**************************************************************************
+// Constructors
+//**************************************************************************
+DecodeCache::DecodeCache(BsaArchive &archive, int byteBudget, QObject *parent) :
+        QObject(parent), mArchive(archive), mCache(byteBudget) {
+    // A reopened archive may have been changed by another program
+    connect(&mArchive, &BsaArchive::archiveOpened, this, &DecodeCache::clear);
+    // fileListModified is also sent on save and close, where the files offsets change
+    connect(&mArchive, &BsaArchive::fileListModified, this, &DecodeCache::dropChangedFiles);
+    connect(&mArchive, &BsaArchive::fileListChanged, this, &DecodeCache::dropChangedFiles);
+}
+
+//**************************************************************************
+// Getters/setters
+//**************************************************************************
+int DecodeCache::byteBudget() const {
+    QMutexLocker locker(&mMutex);
+    return mCache.maxCost();
+}
+
+void DecodeCache::setByteBudget(int byteBudget) {
+    QMutexLocker locker(&mMutex);
+    mCache.setMaxCost(byteBudget);
+}
+
+int DecodeCache::usedBytes() const {
+    QMutexLocker locker(&mMutex);
+    return mCache.totalCost();
+}
+
+int DecodeCache::cachedNumber() const {
+    QMutexLocker locker(&mMutex);
+    return mCache.size();
+}
+
+qint64 DecodeCache::hitNumber() const {
+    QMutexLocker locker(&mMutex);
+    return mHitNumber;
+}
+
+qint64 DecodeCache::missNumber() const {
+    QMutexLocker locker(&mMutex);
+    return mMissNumber;
+}
+
+//**************************************************************************
+// Methods
+//**************************************************************************
+Img DecodeCache::getImg(const BsaFile &file, const Palette &palette) {
+    Key key;
+    Entry entry;
+    if (lookUp(file, palette, FileType::IMG, key, entry)) {
+        return entry.img;
+    }
+    // Decoding outside of the lock so that several files can be decoded at once
+    entry.img = Img(mArchive.getFileData(file), palette);
+    store(key, entry, entry.img.width() * entry.img.height());
+    return entry.img;
+}
+
+Cfa DecodeCache::getCfa(const BsaFile &file, const Palette &palette) {
+    Key key;
+    Entry entry;
+    if (lookUp(file, palette, FileType::CFA, key, entry)) {
+        return entry.cfa;
+    }
+    entry.cfa = Cfa(mArchive.getFileData(file), palette);
+    store(key, entry, entry.cfa.width() * entry.cfa.height() * entry.cfa.qImages().size());
+    return entry.cfa;
+}
+
+void DecodeCache::clear() {
+    QMutexLocker locker(&mMutex);
+    mCache.clear();
+}
+
+void DecodeCache::dropChangedFiles() {
+    QMutexLocker locker(&mMutex);
+    const QList<Key> keys = mCache.keys();
+    for (const auto &key : keys) {
+        BsaFile file = mArchive.getFile(key.fileName);
+        if (!file.isValid() || file.isNew() || file.updated() || file.startOffsetInArchive() != key.offset ||
+            file.size() != key.size || mArchive.getArchiveFilePath() != key.archivePath) {
+            mCache.remove(key);
+        }
+    }
+}
+
+bool DecodeCache::lookUp(const BsaFile &file, const Palette &palette, FileType::Extension type, Key &key,
+                         Entry &entry) {
+    // Using the archive version of the file to know its state
+    BsaFile internFile = mArchive.getFile(file.fileName());
+    if (!internFile.isValid()) {
+        throw Status(-1, QString("The file %1 is not in the archive").arg(file.fileName()));
+    }
+    QMutexLocker locker(&mMutex);
+    if (internFile.isNew() || internFile.updated()) {
+        mMissNumber++;
+        return false;
+    }
+    key.archivePath = mArchive.getArchiveFilePath();
+    key.fileName = internFile.fileName();
+    key.offset = internFile.startOffsetInArchive();
+    key.size = internFile.size();
+    key.paletteId = paletteId(palette);
+    key.type = type;
+    const Entry *cachedEntry = mCache.object(key);
+    if (cachedEntry == nullptr) {
+        mMissNumber++;
+        return false;
+    }
+    mHitNumber++;
+    entry = *cachedEntry;
+    return true;
+}
+
+void DecodeCache::store(const Key &key, const Entry &entry, int cost) {
+    if (key.fileName.isEmpty()) {
+        return;
+    }
+    QMutexLocker locker(&mMutex);
+    // The cache takes ownership of the entry, and deletes it at once if it is larger than the budget
+    mCache.insert(key, new Entry(entry), cost);
+}
+
+quint64 DecodeCache::paletteId(const Palette &palette) {
+    const QVector<QRgb> colorTable = palette.getColorTable();
+    return HashUtils::xxHash64(reinterpret_cast<const char *>(colorTable.constData()),
+                               colorTable.size() * qint64(sizeof(QRgb)));
+}
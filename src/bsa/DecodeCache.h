@@ -0,0 +1,196 @@
+#ifndef BSATOOL_DECODECACHE_H
+#define BSATOOL_DECODECACHE_H
+
+#include <assets/Cfa.h>
+#include <assets/FileType.h>
+#include <assets/Img.h>
+#include <bsa/BsaArchive.h>
+#include <QCache>
+#include <QMutex>
+#include <QObject>
+
+/**
+ * @brief Least recently used cache of the decoded images of an archive
+ *
+ * The decoded IMG and CFA files are kept, up to a budget of bytes of decoded pixels, by (archive path, file name,
+ * offset, size, palette). Only the files stored in the archive are cached: new and updated files are decoded from
+ * their external file each time. Entries are dropped as soon as their file is updated, deleted, moved by a save or
+ * the archive is closed, and the whole cache is cleared when an archive is opened.
+ *
+ * The cache can be used from several threads at once
+ */
+class DecodeCache : public QObject {
+    Q_OBJECT
+public:
+    //**************************************************************************
+    // Statics
+    //**************************************************************************
+    /**
+     * @brief Default budget of decoded pixels bytes: 64 MiB
+     */
+    const static int DEFAULT_BYTE_BUDGET = 67108864;
+
+    //**************************************************************************
+    // Constructors
+    //**************************************************************************
+    /**
+     * @brief constructor of the cache of an archive. The archive must outlive the cache
+     * @param archive the archive whose files are decoded
+     * @param byteBudget maximum number of bytes of decoded pixels kept
+     * @param parent parent object
+     */
+    explicit DecodeCache(BsaArchive &archive, int byteBudget = DEFAULT_BYTE_BUDGET, QObject *parent = nullptr);
+
+    //**************************************************************************
+    // Getters/setters
+    //**************************************************************************
+    /**
+     * @brief maximum number of bytes of decoded pixels kept
+     */
+    [[nodiscard]]int byteBudget() const;
+    /**
+     * @brief set the maximum number of bytes of decoded pixels kept. The least recently used images are dropped if
+     * needed
+     */
+    void setByteBudget(int byteBudget);
+    /**
+     * @brief number of bytes of decoded pixels kept
+     */
+    [[nodiscard]]int usedBytes() const;
+    /**
+     * @brief number of decoded files kept
+     */
+    [[nodiscard]]int cachedNumber() const;
+    /**
+     * @brief number of requests answered from the cache
+     */
+    [[nodiscard]]qint64 hitNumber() const;
+    /**
+     * @brief number of requests needing to decode the file
+     */
+    [[nodiscard]]qint64 missNumber() const;
+
+    //**************************************************************************
+    // Methods
+    //**************************************************************************
+    /**
+     * @brief retrieve a decoded IMG file of the archive
+     * @param file the file
+     * @param palette palette used to display the image if it has no integrated palette
+     * @return the decoded image
+     * @throw Status if the file is not in the archive, is unreadable or is not a valid IMG
+     */
+    Img getImg(const BsaFile &file, const Palette &palette = Palette());
+
+    /**
+     * @brief retrieve a decoded CFA file of the archive
+     * @param file the file
+     * @param palette palette used to display the animation
+     * @return the decoded animation
+     * @throw Status if the file is not in the archive, is unreadable or is not a valid CFA
+     */
+    Cfa getCfa(const BsaFile &file, const Palette &palette = Palette());
+
+public slots:
+    /**
+     * @brief drop all the decoded files
+     */
+    void clear();
+
+private slots:
+    /**
+     * @brief drop the decoded files which are no longer stored as they were in the archive
+     */
+    void dropChangedFiles();
+
+private:
+    //**************************************************************************
+    // Types
+    //**************************************************************************
+    /**
+     * @brief identity of a decoded file
+     */
+    struct Key {
+        QString archivePath{};
+        QString fileName{};
+        qint64 offset{0};
+        quint32 size{0};
+        quint64 paletteId{0};
+        FileType::Extension type{FileType::UNKNOWN};
+
+        bool operator==(const Key &other) const {
+            return offset == other.offset && size == other.size && paletteId == other.paletteId &&
+                   type == other.type && fileName == other.fileName && archivePath == other.archivePath;
+        }
+
+        friend uint qHash(const Key &key, uint seed = 0) {
+            return ::qHash(key.fileName, seed) ^ ::qHash(key.offset, seed) ^ uint(key.paletteId);
+        }
+    };
+
+    /**
+     * @brief decoded file: an image or an animation depending on the key type
+     */
+    struct Entry {
+        Img img{};
+        Cfa cfa{};
+    };
+
+    //**************************************************************************
+    // Attributes
+    //**************************************************************************
+    /**
+     * @brief the archive whose files are decoded
+     */
+    BsaArchive &mArchive;
+
+    /**
+     * @brief decoded files, with their pixels bytes as cost
+     */
+    QCache<Key, Entry> mCache;
+
+    /**
+     * @brief number of requests answered from the cache
+     */
+    qint64 mHitNumber{0};
+
+    /**
+     * @brief number of requests needing to decode the file
+     */
+    qint64 mMissNumber{0};
+
+    /**
+     * @brief mutex protecting the cache and the counters
+     */
+    mutable QMutex mMutex{};
+
+    //**************************************************************************
+    // Methods
+    //**************************************************************************
+    /**
+     * @brief look for a decoded file and count the request
+     * @param file the file
+     * @param palette palette used to decode the file
+     * @param type type of the file
+     * @param key receives the identity of the file if it can be cached
+     * @param entry receives the decoded file if cached
+     * @return true if the file was in the cache
+     * @throw Status if the file is not in the archive
+     */
+    bool lookUp(const BsaFile &file, const Palette &palette, FileType::Extension type, Key &key, Entry &entry);
+
+    /**
+     * @brief keep a decoded file if it can be cached
+     * @param key identity of the file, with an empty file name if it cannot be cached
+     * @param entry the decoded file
+     * @param cost number of bytes of decoded pixels
+     */
+    void store(const Key &key, const Entry &entry, int cost);
+
+    /**
+     * @brief identifier of a palette: hash of its color table
+     */
+    static quint64 paletteId(const Palette &palette);
+};
+
+#endif // BSATOOL_DECODECACHE_H
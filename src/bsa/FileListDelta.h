@@ -0,0 +1,30 @@
+#ifndef BSATOOL_FILELISTDELTA_H
+#define BSATOOL_FILELISTDELTA_H
+
+#include <QMetaType>
+#include <QVector>
+
+/**
+ * @brief Describe a change of the files list of an archive
+ *
+ * The change is applied by removing the files at removedIndexes, then inserting the files at insertedIndexes. The
+ * files at modifiedIndexes have only their state changed. All the indexes are sorted in ascending order
+ */
+struct FileListDelta {
+    /**
+     * @brief indexes, in the list after the change, of the added files
+     */
+    QVector<int> insertedIndexes{};
+    /**
+     * @brief indexes, in the list before the change, of the deleted files
+     */
+    QVector<int> removedIndexes{};
+    /**
+     * @brief indexes, in the list after the change, of the files whose state changed
+     */
+    QVector<int> modifiedIndexes{};
+};
+
+Q_DECLARE_METATYPE(FileListDelta)
+
+#endif // BSATOOL_FILELISTDELTA_H
@@ -0,0 +1,115 @@
+#include <bsa/SequentialReader.h>
+#include <assets/FileType.h>
+#include <error/Status.h>
+#include <QtConcurrent/QtConcurrent>
+
+//**************************************************************************
+// Constructors
+//**************************************************************************
+SequentialReader::SequentialReader(BsaArchive &archive, int prefetchDepth, bool decode, const Palette &palette,
+                                   int decodeDepth) :
+        SequentialReader(archive, archive.getFiles(), prefetchDepth, decode, palette, decodeDepth) {}
+
+SequentialReader::SequentialReader(BsaArchive &archive, const QVector<BsaFile> &files, int prefetchDepth,
+                                   bool decode, const Palette &palette, int decodeDepth) :
+        mArchive(archive), mFiles(files), mPrefetchDepth(qMax(1, prefetchDepth)),
+        mDecodeDepth(decodeDepth > 0 ? decodeDepth : QThread::idealThreadCount()), mDecode(decode),
+        mPalette(palette) {
+    // Files in the archive by offset, then the external ones
+    stable_sort(mFiles.begin(), mFiles.end(), [](const BsaFile &first, const BsaFile &second) {
+        bool firstExternal = first.isNew() || first.updated();
+        bool secondExternal = second.isNew() || second.updated();
+        if (firstExternal != secondExternal) {
+            return secondExternal;
+        }
+        return !firstExternal && first.startOffsetInArchive() < second.startOffsetInArchive();
+    });
+    // A single thread keeps the reads sequential. Decoding is worth more threads
+    mReadPool.setMaxThreadCount(1);
+    mDecodePool.setMaxThreadCount(QThread::idealThreadCount());
+    prefetch();
+}
+
+SequentialReader::~SequentialReader() {
+    mDecodePool.waitForDone();
+    mReadPool.waitForDone();
+}
+
+//**************************************************************************
+// Getters/setters
+//**************************************************************************
+const QVector<BsaFile> &SequentialReader::files() const {
+    return mFiles;
+}
+
+//**************************************************************************
+// Methods
+//**************************************************************************
+bool SequentialReader::hasNext() const {
+    return !mPendingTasks.isEmpty() || !mReadTasks.isEmpty();
+}
+
+SequentialReader::Entry SequentialReader::next() {
+    if (!hasNext()) {
+        throw Status(-1, QStringLiteral("Cannot read : no file left"));
+    }
+    QFuture<Task> task = mPendingTasks.dequeue();
+    // Keeping the background busy while waiting for this file
+    prefetch();
+    Task result = task.result();
+    if (!result.errorMessage.isEmpty()) {
+        throw Status(-1, result.errorMessage);
+    }
+    return result.entry;
+}
+
+void SequentialReader::prefetch() {
+    if (!mDecode) {
+        startReads(mPendingTasks);
+        return;
+    }
+    startReads(mReadTasks);
+    while (mPendingTasks.size() < mDecodeDepth && !mReadTasks.isEmpty()) {
+        mPendingTasks.enqueue(QtConcurrent::run(&mDecodePool, &SequentialReader::decodeFile, mReadTasks.dequeue(),
+                                                mPalette));
+    }
+    // Reading the files replacing the ones handed to decoding
+    startReads(mReadTasks);
+}
+
+void SequentialReader::startReads(QQueue<QFuture<Task>> &tasks) {
+    while (tasks.size() < mPrefetchDepth && mNextIndex < mFiles.size()) {
+        tasks.enqueue(QtConcurrent::run(&mReadPool, &SequentialReader::readFile, std::ref(mArchive),
+                                        mFiles.at(mNextIndex)));
+        mNextIndex++;
+    }
+}
+
+SequentialReader::Task SequentialReader::readFile(BsaArchive &archive, const BsaFile &file) {
+    Task task;
+    task.entry.file = file;
+    try {
+        task.entry.data = archive.getFileData(file);
+    } catch (Status &e) {
+        task.errorMessage = QString("%1 : %2").arg(file.fileName(), e.message());
+    }
+    return task;
+}
+
+SequentialReader::Task SequentialReader::decodeFile(QFuture<Task> readTask, const Palette &palette) {
+    Task task = readTask.result();
+    if (!task.errorMessage.isEmpty()) {
+        return task;
+    }
+    try {
+        FileType::Extension extension = FileType::getExtension(task.entry.file);
+        if (extension == FileType::IMG) {
+            task.entry.img = Img(task.entry.data, palette);
+        } else if (extension == FileType::CFA) {
+            task.entry.cfa = Cfa(task.entry.data, palette);
+        }
+    } catch (Status &e) {
+        task.errorMessage = QString("%1 : %2").arg(task.entry.file.fileName(), e.message());
+    }
+    return task;
+}
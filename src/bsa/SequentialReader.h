@@ -0,0 +1,219 @@
+#ifndef BSATOOL_SEQUENTIALREADER_H
+#define BSATOOL_SEQUENTIALREADER_H
+
+#include <assets/Cfa.h>
+#include <assets/Img.h>
+#include <bsa/BsaArchive.h>
+#include <QFuture>
+#include <QQueue>
+#include <QThreadPool>
+
+/**
+ * @brief Read the files of an archive one after the other in the order of their data in the archive
+ *
+ * Reading the files in name order makes the reads jump around the archive. The reader walks the files by offset
+ * instead (new and updated files, stored outside of the archive, come last, by name) and reads the next ones on a
+ * single background thread while the current one is used, so that the processing of a file overlaps the reading of
+ * the next ones. The reader can also decode the IMG and CFA files on a separate pool of threads, so that decoding
+ * never breaks the order of the reads.
+ *
+ * At most prefetchDepth files read but not yet handed to decoding, plus decodeDepth files being decoded, are held by
+ * the reader at once. The archive must not be modified, saved or closed while the reader is used
+ */
+class SequentialReader {
+public:
+    //**************************************************************************
+    // Statics
+    //**************************************************************************
+    /**
+     * @brief Default number of files read in advance: the current one is used while the next one is read
+     */
+    const static int DEFAULT_PREFETCH_DEPTH = 2;
+
+    /**
+     * @brief Default number of files decoded in advance: 0 for one per processor
+     */
+    const static int DEFAULT_DECODE_DEPTH = 0;
+
+    /**
+     * @brief File read by the reader
+     */
+    struct Entry {
+        /**
+         * @brief the file
+         */
+        BsaFile file{};
+        /**
+         * @brief data of the file
+         */
+        QVector<char> data{};
+        /**
+         * @brief decoded image, if the file is an IMG and decoding is enabled
+         */
+        Img img{};
+        /**
+         * @brief decoded animation, if the file is a CFA and decoding is enabled
+         */
+        Cfa cfa{};
+    };
+
+    //**************************************************************************
+    // Constructors
+    //**************************************************************************
+    /**
+     * @brief constructor of a reader of all the files of an archive. The reading starts at once
+     * @param archive the archive to read. It must outlive the reader
+     * @param prefetchDepth number of files read in advance, at least 1
+     * @param decode true to decode the IMG and CFA files in the background
+     * @param palette palette used to decode the files
+     * @param decodeDepth number of files decoded in advance, 0 for one per processor. Unused without decoding
+     */
+    explicit SequentialReader(BsaArchive &archive, int prefetchDepth = DEFAULT_PREFETCH_DEPTH, bool decode = false,
+                              const Palette &palette = Palette(), int decodeDepth = DEFAULT_DECODE_DEPTH);
+    /**
+     * @brief constructor of a reader of some files of an archive. The reading starts at once. External files are read
+     * last, in the given order
+     * @param archive the archive to read. It must outlive the reader
+     * @param files the files to read
+     * @param prefetchDepth number of files read in advance, at least 1
+     * @param decode true to decode the IMG and CFA files in the background
+     * @param palette palette used to decode the files
+     * @param decodeDepth number of files decoded in advance, 0 for one per processor. Unused without decoding
+     */
+    SequentialReader(BsaArchive &archive, const QVector<BsaFile> &files, int prefetchDepth = DEFAULT_PREFETCH_DEPTH,
+                     bool decode = false, const Palette &palette = Palette(), int decodeDepth = DEFAULT_DECODE_DEPTH);
+    /**
+     * @brief destructor. Waits for the files being read and decoded
+     */
+    ~SequentialReader();
+
+    SequentialReader(const SequentialReader &) = delete;
+    SequentialReader &operator=(const SequentialReader &) = delete;
+
+    //**************************************************************************
+    // Getters/setters
+    //**************************************************************************
+    /**
+     * @brief the files to read, in reading order
+     */
+    [[nodiscard]]const QVector<BsaFile> &files() const;
+
+    //**************************************************************************
+    // Methods
+    //**************************************************************************
+    /**
+     * @brief true if there are files left to read
+     */
+    [[nodiscard]]bool hasNext() const;
+
+    /**
+     * @brief retrieve the next file, waiting for it if it is not read yet. A failing file does not stop the reading:
+     * next can be called again to get the following file
+     * @return the next file with its data and, if enabled, its decoded content
+     * @throw Status if there is no file left, or if the file cannot be read or decoded
+     */
+    Entry next();
+
+private:
+    //**************************************************************************
+    // Types
+    //**************************************************************************
+    /**
+     * @brief result of the background reading of a file: the entry or the error
+     */
+    struct Task {
+        Entry entry{};
+        QString errorMessage{};
+    };
+
+    //**************************************************************************
+    // Attributes
+    //**************************************************************************
+    /**
+     * @brief the archive to read
+     */
+    BsaArchive &mArchive;
+
+    /**
+     * @brief the files to read, in reading order
+     */
+    QVector<BsaFile> mFiles;
+
+    /**
+     * @brief index in mFiles of the next file to start reading
+     */
+    int mNextIndex{0};
+
+    /**
+     * @brief number of files read in advance
+     */
+    int mPrefetchDepth;
+
+    /**
+     * @brief number of files decoded in advance
+     */
+    int mDecodeDepth;
+
+    /**
+     * @brief true to decode the IMG and CFA files in the background
+     */
+    bool mDecode;
+
+    /**
+     * @brief palette used to decode the files
+     */
+    Palette mPalette;
+
+    /**
+     * @brief files being read and not handed to decoding yet, in reading order. Unused without decoding
+     */
+    QQueue<QFuture<Task>> mReadTasks{};
+
+    /**
+     * @brief files to give next, being read or decoded, in reading order
+     */
+    QQueue<QFuture<Task>> mPendingTasks{};
+
+    /**
+     * @brief single thread reading the files, so that the reads stay in offset order
+     */
+    QThreadPool mReadPool{};
+
+    /**
+     * @brief threads decoding the files
+     */
+    QThreadPool mDecodePool{};
+
+    //**************************************************************************
+    // Methods
+    //**************************************************************************
+    /**
+     * @brief start reading files until prefetchDepth files are read in advance, and hand the read files to decoding
+     * until decodeDepth files are decoded in advance
+     */
+    void prefetch();
+
+    /**
+     * @brief start reading files until prefetchDepth files are queued in the given queue
+     * @param tasks the queue receiving the reads
+     */
+    void startReads(QQueue<QFuture<Task>> &tasks);
+
+    /**
+     * @brief read a file
+     * @param archive the archive to read
+     * @param file the file to read
+     * @return the entry, or the error message if the file cannot be read
+     */
+    static Task readFile(BsaArchive &archive, const BsaFile &file);
+
+    /**
+     * @brief decode a file once read, if it is an IMG or a CFA
+     * @param readTask the reading of the file
+     * @param palette palette used to decode the file
+     * @return the entry, or the error message if the file cannot be read or decoded
+     */
+    static Task decodeFile(QFuture<Task> readTask, const Palette &palette);
+};
+
+#endif // BSATOOL_SEQUENTIALREADER_H
@@ -1,27 +1,10 @@
 #include <error/Status.h>
 #include <utils/BitsStreams.h>
 
-//**************************************************************************
-// Statics
-//**************************************************************************
-uchar BitsReader::getNextUnsignedByte(deque<char> &data) {
-    return uchar(getNextByte(data));
-}
-
-char BitsReader::getNextByte(deque<char> &data) {
-    if (data.empty()) {
-        throw Status(-1, QStringLiteral("Unexpected end of data"));
-    }
-    // copy value before freeing memory
-    char byte = data.front();
-    data.pop_front();
-    return byte;
-}
-
 //**************************************************************************
 // Constructors
 //**************************************************************************
-BitsReader::BitsReader(deque<char> &source): mSource(source) {}
+BitsReader::BitsReader(const char *begin, const char *end): mCurrent(begin), mEnd(end) {}
 
 BitsWriter::BitsWriter(QVector<char> &destination): mDestination(destination) {}
 
@@ -36,8 +19,8 @@ quint8 BitsReader::getBits() {
     // if needed, getting 8 new bits to ensure having at least 8 usable
     while (mBitsBuffer.mRemainingBits <= NB_BITS_IN_BYTE) {
         quint16 nextBits;
-        if (!mSource.empty()) {
-            nextBits = getNextUnsignedByte(mSource) & 0x00FFu;
+        if (mCurrent != mEnd) {
+            nextBits = quint8(*mCurrent++);
         } else {
             nextBits = 0x0000u;
         }
@@ -69,6 +52,16 @@ void BitsWriter::addBits(const quint8 byte, const quint8 nbBits) {
     mBitsBuffer.mRemainingBits += nbBits;
 }
 
+void BitsWriter::addLowBits(quint64 code, quint8 nbBits) {
+    // adding the bits by bytes, the highest ones first
+    while (nbBits > 0) {
+        quint8 nbBitsToAdd = min(nbBits, NB_BITS_IN_BYTE);
+        nbBits -= nbBitsToAdd;
+        quint8 byte = quint8(code >> nbBits) << (NB_BITS_IN_BYTE - nbBitsToAdd);
+        addBits(byte, nbBitsToAdd);
+    }
+}
+
 void BitsWriter::flush() {
     while (mBitsBuffer.mRemainingBits > 0) {
         flushHighByte();
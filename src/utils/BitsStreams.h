@@ -1,8 +1,8 @@
 #ifndef BSATOOL_BITSSTREAMS_H
 #define BSATOOL_BITSSTREAMS_H
 
-#include <deque>
 #include <QVector>
+#include <error/Status.h>
 
 using namespace std;
 
@@ -30,7 +30,7 @@ struct BitsBuffer {
 };
 
 /**
- * Helper class to read bits from a source
+ * Helper class to read bits from a source. The source is read in place through a cursor, without any copy
  */
 class BitsReader {
 private:
@@ -38,9 +38,13 @@ private:
     // Attributes
     //**************************************************************************
     /**
-     * Source from which read bits. Ensure that the destination is readable when using the reader
+     * Next byte to read from the source. Ensure that the source is readable when using the reader
      */
-    deque<char> &mSource;
+    const char *mCurrent;
+    /**
+     * End of the source
+     */
+    const char *mEnd;
     /**
      * Bits buffer
      */
@@ -55,29 +59,32 @@ public:
      */
     const static quint8 NB_BITS_IN_BYTE = 8;
     /**
-     * Extract the front byte of the deque as an unsigned byte and remove it from the deque
-     * @param source data from which extract the front byte
+     * Read the byte at the cursor as an unsigned byte and move the cursor to the next byte
+     * @param current cursor on the data from which read the byte
+     * @param end end of the data
      * @return the next unsigned byte
-     * @throw Status if source is empty
+     * @throw Status if the cursor is at the end of the data
      */
-    static uchar getNextUnsignedByte(deque<char> &source);
+    static uchar getNextUnsignedByte(const char *&current, const char *end);
 
     /**
-     * Extract the front byte of the deque and remove it from the deque
-     * @param source data from which extract the front byte
+     * Read the byte at the cursor and move the cursor to the next byte
+     * @param current cursor on the data from which read the byte
+     * @param end end of the data
      * @return the next byte
-     * @throw Status if source is empty
+     * @throw Status if the cursor is at the end of the data
      */
-    static char getNextByte(deque<char> &source);
+    static char getNextByte(const char *&current, const char *end);
 
     //**************************************************************************
     // Constructors
     //**************************************************************************
     /**
      * construct a reader from the given source
-     * @param source source from which read the bits
+     * @param begin first byte of the source from which read the bits
+     * @param end end of the source
      */
-    explicit BitsReader(deque<char> &source);
+    BitsReader(const char *begin, const char *end);
     //**************************************************************************
     // Methods
     //**************************************************************************
@@ -107,7 +114,7 @@ public:
 };
 
 /**
- * Helper class to write bits to a destination deque
+ * Helper class to write bits to a destination vector
  */
 class BitsWriter {
 private:
@@ -151,6 +158,13 @@ public:
      */
     void addBits(quint8 byte, quint8 nbBits);
 
+    /**
+     * Add the lowest bits of a code, highest first, and write bits if needed to avoid an overflow
+     * @param code bits to write, in its lowest bits
+     * @param nbBits number of bits usable in code, up to 64
+     */
+    void addLowBits(quint64 code, quint8 nbBits);
+
     /**
      * Write the bits currently contained in the buffer
      */
@@ -158,4 +172,21 @@ public:
 };
 
 
+//**************************************************************************
+// Definitions
+//**************************************************************************
+
+// Statics, defined here since the codecs call them for each byte
+
+inline uchar BitsReader::getNextUnsignedByte(const char *&current, const char *end) {
+    return uchar(getNextByte(current, end));
+}
+
+inline char BitsReader::getNextByte(const char *&current, const char *end) {
+    if (current == end) {
+        throw Status(-1, QStringLiteral("Unexpected end of data"));
+    }
+    return *current++;
+}
+
 #endif //BSATOOL_BITSSTREAMS_H
@@ -1,7 +1,8 @@
 #include <error/Status.h>
-#include <deque>
 #include <utils/Compression.h>
 #include <utils/HuffmanTree.h>
+#include <cstring>
+#include <limits>
 
 // alias
 typedef SlidingWindow<char, 4096> SWChar4096;
@@ -10,11 +11,42 @@ typedef SlidingWindow<char, 4096> SWChar4096;
 // Methods
 //**************************************************************************
 QVector<char> Compression::uncompressLZSS(const QVector<char> &compressedData) {
-    // deque to allow fast first element removal and random element access
-    deque<char> compressDataDeque;
-    for (const auto &byte : compressedData) {
-        compressDataDeque.push_back(byte);
-    }
+    // The uncompressed size is unknown: starting from a usual ratio, the buffer grows as needed
+    QVector<char> uncompressedData(int(qBound(qint64(1024), qint64(compressedData.size()) * 3,
+                                              qint64(std::numeric_limits<int>::max()))));
+    const qint64 uncompressedSize = uncompressLZSS(DataView(compressedData), &uncompressedData,
+                                                   uncompressedData.data(), uncompressedData.size());
+    uncompressedData.resize(int(uncompressedSize));
+    return uncompressedData;
+}
+
+qint64 Compression::uncompressLZSS(const DataView &compressedData, char *uncompressedData, qint64 uncompressedSize) {
+    return uncompressLZSS(compressedData, nullptr, uncompressedData, uncompressedSize);
+}
+
+qint64 Compression::uncompressLZSS(const DataView &compressedData, QVector<char> *growableData, char *uncompressedData,
+                                   qint64 uncompressedSize) {
+    // cursor reading the compressed data in place
+    const char *current = compressedData.begin();
+    const char *end = compressedData.end();
+    // cursor writing the uncompressed data
+    char *output = uncompressedData;
+    const char *outputEnd = uncompressedData + uncompressedSize;
+    // makes room for at least neededSize more bytes, or throws if the buffer cannot grow
+    auto reserveOutput = [&](qint64 neededSize) {
+        if (growableData == nullptr) {
+            throw Status(-1, QStringLiteral("Uncompressed data larger than expected"));
+        }
+        const qint64 writtenSize = output - uncompressedData;
+        const qint64 grownSize = qMax(qint64(growableData->size()) * 2, writtenSize + neededSize);
+        if (writtenSize + neededSize > std::numeric_limits<int>::max()) {
+            throw Status(-1, QStringLiteral("Uncompressed data too large"));
+        }
+        growableData->resize(int(qMin(grownSize, qint64(std::numeric_limits<int>::max()))));
+        uncompressedData = growableData->data();
+        output = uncompressedData + writtenSize;
+        outputEnd = uncompressedData + growableData->size();
+    };
     // init sliding window
     SWChar4096 window(false);
     for (int i(0); i < 0xFEE; ++i) {
@@ -24,46 +56,48 @@ QVector<char> Compression::uncompressLZSS(const QVector<char> &compressedData) {
     // Higher bits are used to know how many flags are remaining
     // Lower bits indicate a sequence copy from window if 0, copy the next incoming byte if 1
     quint16 flags(0);
-    // uncompressed data
-    QVector<char> uncompressedData;
     // uncompression process
-    while (!compressDataDeque.empty()) {
+    while (current != end) {
         // shifting flags and getting next 8 if empty
         flags = flags >> 1u;
         if ((flags & 0xFF00u) == 0) {
-            flags = BitsReader::getNextUnsignedByte(compressDataDeque) | 0xFF00u;
+            flags = BitsReader::getNextUnsignedByte(current, end) | 0xFF00u;
         }
         // need to insert next byte
         if ((flags & 0x01u) == 1) {
-            char nextByte = BitsReader::getNextByte(compressDataDeque);
-            uncompressedData.push_back(nextByte);
+            char nextByte = BitsReader::getNextByte(current, end);
+            if (output == outputEnd) {
+                reserveOutput(1);
+            }
+            *output++ = nextByte;
             // sliding window
             window.insert(nextByte);
         }
         // need to copy sequence from window
         else {
-            quint8 byte1 = BitsReader::getNextUnsignedByte(compressDataDeque);
-            quint8 byte2 = BitsReader::getNextUnsignedByte(compressDataDeque);
+            quint8 byte1 = BitsReader::getNextUnsignedByte(current, end);
+            quint8 byte2 = BitsReader::getNextUnsignedByte(current, end);
             quint8 length = (byte2 & 0x0Fu) + 3;
             quint16 startIndex = ((byte2 & 0xF0u) << 4u) | byte1;
+            if (outputEnd - output < length) {
+                reserveOutput(length);
+            }
             // copying sequence
             for (int offset = 0; offset < length; ++offset) {
                 char uncompressByte = window.readAtIndex(startIndex + offset);
-                uncompressedData.push_back(uncompressByte);
+                *output++ = uncompressByte;
                 // sliding window
                 window.insert(uncompressByte);
             }
         }
     }
-    return move(uncompressedData);
+    return output - uncompressedData;
 }
 
 QVector<char> Compression::compressLZSS(const QVector<char> &uncompressData) {
-    // deque to allow fast first element removal and random element access
-    deque<char> uncompressDataDeque;
-    for (const auto &byte : uncompressData) {
-        uncompressDataDeque.push_back(byte);
-    }
+    // cursor reading the uncompressed data in place
+    const char *current = uncompressData.constData();
+    const char *end = current + uncompressData.size();
     // Max possible length for a duplicate
     // cannot be higher than 18 because length-3 should take at most 4 bits
     const quint8 max_duplicate_length(18);
@@ -82,7 +116,7 @@ QVector<char> Compression::compressLZSS(const QVector<char> &uncompressData) {
     quint8 flags(0);
     // compressedData
     QVector<char> compressedData;
-    while (!uncompressDataDeque.empty()) {
+    while (current != end) {
         // if flags full, need to write buffer
         if (flagsNumber == 8) {
             // Writing flags, then buffer
@@ -95,8 +129,8 @@ QVector<char> Compression::compressLZSS(const QVector<char> &uncompressData) {
             compressedBytesBuffer.clear();
         }
         // search for a duplicate
-        const SWChar4096::DuplicateSearchResult duplicate = window.searchDuplicateInSlidingWindow(uncompressDataDeque,
-                                                                                                   max_duplicate_length);
+        const SWChar4096::DuplicateSearchResult duplicate = window.searchDuplicateInSlidingWindow(
+                current, size_t(end - current), max_duplicate_length);
         // Writing compressed data to buffer
         if (duplicate.length > 2) {
             // next flag is 0
@@ -110,8 +144,8 @@ QVector<char> Compression::compressLZSS(const QVector<char> &uncompressData) {
             compressedBytesBuffer.push_back(char(byte2));
             // sliding window
             for (int i(0); i < duplicate.length; i++) {
-                window.insert(uncompressDataDeque.front());
-                uncompressDataDeque.pop_front();
+                window.insert(*current);
+                current++;
             }
         } else {
             // next flag is 1
@@ -119,11 +153,11 @@ QVector<char> Compression::compressLZSS(const QVector<char> &uncompressData) {
             flags |= 0x80u;
             flagsNumber++;
             // writing next byte to copy
-            const char &nextUncompressByte = uncompressDataDeque.front();
+            const char &nextUncompressByte = *current;
             compressedBytesBuffer.push_back(nextUncompressByte);
             // sliding window
             window.insert(nextUncompressByte);
-            uncompressDataDeque.pop_front();
+            current++;
         }
     }
     // If less than 8 operations because end of file, need to flush the remaining buffer
@@ -138,30 +172,32 @@ QVector<char> Compression::compressLZSS(const QVector<char> &uncompressData) {
 }
 
 QVector<char> Compression::uncompressDeflate(const QVector<char> &compressedData, const uint &uncompressedSize) {
+    QVector<char> uncompressedData(static_cast<int>(uncompressedSize));
+    uncompressDeflate(DataView(compressedData), uncompressedData.data(), uncompressedData.size());
+    return uncompressedData;
+}
+
+void Compression::uncompressDeflate(const DataView &compressedData, char *uncompressedData, qint64 uncompressedSize) {
     // init huffman tree
     HuffmanTree huffmanTree = HuffmanTree();
-    // deque to allow fast first element removal and random element access
-    deque<char> compressDataDeque;
-    for (const auto &byte : compressedData) {
-        compressDataDeque.push_back(byte);
-    }
     // init sliding window
     SWChar4096 window(false);
     for (int i(0); i < 4036; ++i) {
         window.insert(0x20);
     }
-    // uncompressed data
-    QVector<char> uncompressedData;
-    // bits reader to manage reading of incoming bits from compressed data
-    BitsReader bitsReader(compressDataDeque);
+    // cursor writing the uncompressed data
+    char *output = uncompressedData;
+    const char *outputEnd = uncompressedData + uncompressedSize;
+    // bits reader to manage reading of incoming bits from compressed data, in place
+    BitsReader bitsReader(compressedData.begin(), compressedData.end());
     // decompressing data from source
-    while (uncompressedData.size() < uncompressedSize) {
+    while (output != outputEnd) {
         // searching leaf value in tree from input. The real value is the leaf value minus 627
         quint16 colorOrNbToCopy = huffmanTree.findLeaf(bitsReader) - 627;
         // single byte copy
         if (colorOrNbToCopy < 256) {
             quint8 colorByte = colorOrNbToCopy & 0x00FFu;
-            uncompressedData.push_back(char(colorByte));
+            *output++ = char(colorByte);
             window.insert(char(colorByte));
         }
         // copy string from window
@@ -187,25 +223,25 @@ QVector<char> Compression::uncompressDeflate(const QVector<char> &compressedData
             // getting length from leaf value (minus 256 because 256 color leaves before length leaves)
             // the length value stored in leaves is the length - 3
             quint16 nbToCopy = colorOrNbToCopy - 256 + 3;
+            if (outputEnd - output < nbToCopy) {
+                throw Status(-1, QStringLiteral("Uncompressed data larger than expected"));
+            }
             // string copy
             for (quint16 i(0); i < nbToCopy; i++) {
                 quint8 colorByte = window.readAtIndex(copyPosition + i);
-                uncompressedData.push_back(char(colorByte));
+                *output++ = char(colorByte);
                 window.insert(char(colorByte));
             }
         }
     }
-    return move(uncompressedData);
 }
 
 QVector<char> Compression::compressDeflate(const QVector<char> &uncompressedData) {
     // init huffman tree
     HuffmanTree huffmanTree = HuffmanTree();
-    // deque to allow fast first element removal and random element access
-    deque<char> uncompressDataDeque;
-    for (const auto &byte : uncompressedData) {
-        uncompressDataDeque.push_back(byte);
-    }
+    // cursor reading the uncompressed data in place
+    const char *current = uncompressedData.constData();
+    const char *end = current + uncompressedData.size();
     // init sliding window
     SWChar4096 window;
     for (int i(0); i < 4036; ++i) {
@@ -219,10 +255,10 @@ QVector<char> Compression::compressDeflate(const QVector<char> &uncompressedData
     // bits writer to manage writing of produced bits
     BitsWriter bitsWriter(compressedData);
     // decompressing data from source
-    while (!uncompressDataDeque.empty()) {
+    while (current != end) {
         // search for a duplicate
-        const SWChar4096::DuplicateSearchResult duplicate = window.searchDuplicateInSlidingWindow(uncompressDataDeque,
-                                                                                                   max_duplicate_length);
+        const SWChar4096::DuplicateSearchResult duplicate = window.searchDuplicateInSlidingWindow(
+                current, size_t(end - current), max_duplicate_length);
         // string copy
         if (duplicate.length > 2) {
             // computing offset from current insert position to save in compressed data
@@ -248,16 +284,16 @@ QVector<char> Compression::compressDeflate(const QVector<char> &uncompressedData
             quint8 offsetBitsToGetFromStream = offsetFromCurrentPosition << nbGarbageBits;
             bitsWriter.addBits(offsetBitsToGetFromStream, nbBitsToGetFromStream);
             for (quint16 i(0); i < duplicate.length; i++) {
-                window.insert(uncompressDataDeque.front());
-                uncompressDataDeque.pop_front();
+                window.insert(*current);
+                current++;
             }
         }
             // single byte copy
         else {
-            quint8 colorByte = uncompressDataDeque.front();
+            quint8 colorByte = *current;
             huffmanTree.writePathForLeaf(bitsWriter, colorByte + 627);
             window.insert(char(colorByte));
-            uncompressDataDeque.pop_front();
+            current++;
         }
     }
     bitsWriter.flush();
@@ -266,48 +302,57 @@ QVector<char> Compression::compressDeflate(const QVector<char> &uncompressedData
 
 QVector<char>
 Compression::uncompressRLEByLine(const QVector<char> &compressedData, const uint &width, const uint &height) {
-    // deque to allow fast first element removal and random element access
-    deque<char> compressDataDeque;
-    for (auto &byte : compressedData) {
-        compressDataDeque.push_back(byte);
-    }
-    // uncompressed data
-    QVector<char> uncompressedData;
+    QVector<char> uncompressedData(int(width * height));
+    uncompressRLEByLine(DataView(compressedData), uncompressedData.data(), width, height);
+    return uncompressedData;
+}
+
+void Compression::uncompressRLEByLine(const DataView &compressedData, char *uncompressedData, const uint &width,
+                                      const uint &height) {
+    // cursor reading the compressed data in place
+    const char *current = compressedData.begin();
+    const char *end = compressedData.end();
+    // cursor writing the uncompressed data
+    char *output = uncompressedData;
     // For each line of pixels
     for (int line(0); line < height; line++) {
         // while not done with this line
         uint bytesLeftToProduce = width;
         while (bytesLeftToProduce > 0) {
             // getting number of bytes for this operation
-            quint8 counter = BitsReader::getNextUnsignedByte(compressDataDeque);
+            quint8 counter = BitsReader::getNextUnsignedByte(current, end);
             // stream of same colors
             if (counter >= 128) {
                 counter = (counter & 0x7Fu) + 1u;
-                char color = BitsReader::getNextByte(compressDataDeque);
-                for (int i(0); i < counter; i++) {
-                    uncompressedData.push_back(color);
+                char color = BitsReader::getNextByte(current, end);
+                if (counter > bytesLeftToProduce) {
+                    throw Status(-1, QStringLiteral("Uncompressed data larger than expected"));
                 }
+                memset(output, color, counter);
             }
                 // stream of different colors
             else {
                 counter++;
-                for (int i(0); i < counter; i++) {
-                    uncompressedData.push_back(BitsReader::getNextByte(compressDataDeque));
+                if (counter > bytesLeftToProduce) {
+                    throw Status(-1, QStringLiteral("Uncompressed data larger than expected"));
+                }
+                if (end - current < counter) {
+                    throw Status(-1, QStringLiteral("Unexpected end of data"));
                 }
+                memcpy(output, current, counter);
+                current += counter;
             }
+            output += counter;
             bytesLeftToProduce -= counter;
         }
     }
-    return move(uncompressedData);
 }
 
 QVector<char>
 Compression::compressRLEByLine(const QVector<char> &uncompressedData, const uint &width, const uint &height) {
-    // deque to allow fast first element removal and random element access
-    deque<char> uncompressDataDeque;
-    for (const auto &byte : uncompressedData) {
-        uncompressDataDeque.push_back(byte);
-    }
+    // cursor reading the uncompressed data in place
+    const char *current = uncompressedData.constData();
+    const char *end = current + uncompressedData.size();
     // compressed data
     QVector<char> compressedData;
     // For each line of pixels
@@ -319,51 +364,49 @@ Compression::compressRLEByLine(const QVector<char> &uncompressedData, const uint
             if (bytesLeftToConsume == 1) {
                 quint8 counterValueToWrite(0);
                 compressedData.push_back(char(counterValueToWrite));
-                compressedData.push_back(BitsReader::getNextByte(uncompressDataDeque));
+                compressedData.push_back(BitsReader::getNextByte(current, end));
                 bytesLeftToConsume--;
             }
                 // need to explore the sequence
             else {
                 quint8 counter(0);
                 // need at least two bytes in data to explore sequence
-                if (uncompressDataDeque.size() < 2) {
+                if (end - current < 2) {
                     throw Status(-1, QStringLiteral("Unexpected end of data"));
                 }
                 // stream of different color
-                if (uncompressDataDeque[counter] != uncompressDataDeque[counter + 1]) {
+                if (current[counter] != current[counter + 1]) {
                     // computing sequence length
-                    while (uncompressDataDeque.size() - counter >= 2 &&
-                           uncompressDataDeque[counter] != uncompressDataDeque[counter + 1] &&
+                    while (size_t(end - current) - counter >= 2 &&
+                           current[counter] != current[counter + 1] &&
                            counter < 128 &&
                            bytesLeftToConsume - counter > 0) {
                         counter++;
                     }
                     // adding last byte of this line if possible because line per line
-                    if (counter < 128 && bytesLeftToConsume - counter == 1 && !uncompressDataDeque.empty()) {
+                    if (counter < 128 && bytesLeftToConsume - counter == 1 && current != end) {
                         counter++;
                     }
                     // Writing compressed data and consuming uncompressed
                     compressedData.push_back(char(counter - 1));
                     for (int i(0); i < counter; i++) {
-                        compressedData.push_back(BitsReader::getNextByte(uncompressDataDeque));
+                        compressedData.push_back(BitsReader::getNextByte(current, end));
                     }
                     bytesLeftToConsume -= counter;
                 }
                     // stream of same color
                 else {
                     // computing sequence length
-                    while (uncompressDataDeque.size() - counter > 0 &&
-                           uncompressDataDeque[0] == uncompressDataDeque[counter] &&
+                    while (size_t(end - current) - counter > 0 &&
+                           current[0] == current[counter] &&
                            counter < 128 &&
                            bytesLeftToConsume - counter > 0) {
                         counter++;
                     }
                     // Writing compressed data and consuming uncompressed
                     compressedData.push_back(char((counter - 1u) | 0x80u));
-                    compressedData.push_back(uncompressDataDeque[0]);
-                    for (int i(0); i < counter; i++) {
-                        uncompressDataDeque.pop_front();
-                    }
+                    compressedData.push_back(current[0]);
+                    current += counter;
                     bytesLeftToConsume -= counter;
                 }
             }
@@ -380,25 +423,44 @@ QVector<char> Compression::compressRLE(const QVector<char> &uncompressedData) {
     return compressRLEByLine(uncompressedData, uncompressedData.size(), 1);
 }
 
-QVector<char> Compression::encryptDecrypt(const QVector<char> &data, QVector<quint8> cryptKey) {
-    // deque to allow fast first element removal and random element access
-    deque<char> dataDeque;
-    for (const auto &byte : data) {
-        dataDeque.push_back(byte);
+qint64 Compression::decode(quint8 compressionFlag, const DataView &compressedData, char *uncompressedData,
+                          const uint &width, const uint &height) {
+    const qint64 uncompressedSize = qint64(width) * height;
+    switch (compressionFlag) {
+        case 0x00:
+            if (compressedData.size() > uncompressedSize) {
+                throw Status(-1, QStringLiteral("Uncompressed data larger than expected"));
+            }
+            memcpy(uncompressedData, compressedData.data(), size_t(compressedData.size()));
+            return compressedData.size();
+        case 0x02:
+            uncompressRLEByLine(compressedData, uncompressedData, width, height);
+            return uncompressedSize;
+        case 0x04:
+            return uncompressLZSS(compressedData, uncompressedData, uncompressedSize);
+        case 0x08:
+            uncompressDeflate(compressedData, uncompressedData, uncompressedSize);
+            return uncompressedSize;
+        default:
+            throw Status(-1, QStringLiteral("This image compression is not supported : ") +
+                             QString::number(compressionFlag));
     }
+}
+
+QVector<char> Compression::encryptDecrypt(const QVector<char> &data, QVector<quint8> cryptKey) {
     // encryption cycles through cryptKey
     int cryptKeyIndex(0);
     // counter resets after 256 operations
     quint8 counter(0);
     // output
     QVector<char> cryptData;
-    cryptData.reserve(int(dataDeque.size()));
+    cryptData.reserve(data.size());
     // encryption / decryption process
-    while (!dataDeque.empty()) {
+    for (const auto &byte : data) {
         // real key to XOR against
         quint8 effectiveKey = counter + cryptKey[cryptKeyIndex];
         // pushing new encrypted / decrypted byte
-        cryptData.push_back(char(BitsReader::getNextUnsignedByte(dataDeque) ^ effectiveKey));
+        cryptData.push_back(char(quint8(byte) ^ effectiveKey));
         // preparing next step
         counter++;
         cryptKeyIndex = (cryptKeyIndex + 1) % cryptKey.size();
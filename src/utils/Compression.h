@@ -2,7 +2,7 @@
 #define BSATOOL_COMPRESSION_H
 
 #include <QtCore/QVector>
-#include <deque>
+#include <utils/DataView.h>
 #include <utils/SlidingWindow.h>
 
 using namespace std;
@@ -70,6 +70,16 @@ public:
      */
     static QVector<char> uncompressLZSS(const QVector<char> &compressedData);
 
+    /**
+     * Uncompressed data with a LZSS algorithm into a buffer given by the caller
+     * @param compressedData to uncompress
+     * @param uncompressedData buffer receiving the uncompressed data
+     * @param uncompressedSize size of the buffer
+     * @return the number of bytes written in the buffer
+     * @throw Status if the compressed data is truncated or does not fit in the buffer
+     */
+    static qint64 uncompressLZSS(const DataView &compressedData, char *uncompressedData, qint64 uncompressedSize);
+
     /**
      * Compressed data with a LZSS algorithm
      * @param uncompressedData to compress
@@ -84,6 +94,15 @@ public:
      */
     static QVector<char> uncompressDeflate(const QVector<char> &compressedData, const uint &uncompressedSize);
 
+    /**
+     * Uncompressed data with a deflate algorithm into a buffer given by the caller
+     * @param compressedData to uncompress
+     * @param uncompressedData buffer receiving the uncompressed data
+     * @param uncompressedSize size of the buffer, filled entirely
+     * @throw Status if the last copied sequence goes past the end of the buffer
+     */
+    static void uncompressDeflate(const DataView &compressedData, char *uncompressedData, qint64 uncompressedSize);
+
     /**
      * Compressed data with a deflate algorithm
      * @param uncompressedData to compress
@@ -98,6 +117,16 @@ public:
      */
     static QVector<char> uncompressRLEByLine(const QVector<char> &compressedData, const uint &width, const uint &height);
 
+    /**
+     * Uncompressed data with a run length algorithm running by line of data in the image into a buffer given by the
+     * caller
+     * @param compressedData to uncompress
+     * @param uncompressedData buffer receiving the uncompressed data, of width * height bytes
+     * @throw Status if the compressed data is truncated or a run goes past the end of its line
+     */
+    static void uncompressRLEByLine(const DataView &compressedData, char *uncompressedData, const uint &width,
+                                    const uint &height);
+
     /**
      * Compressed data with a run length algorithm running by line of data in the image
      * @param uncompressedData to compress
@@ -119,6 +148,20 @@ public:
      */
     static QVector<char> compressRLE(const QVector<char> &uncompressedData);
 
+    /**
+     * Uncompressed image data according to its compression flag into a buffer given by the caller, such as the pixels
+     * backing a QImage
+     * @param compressionFlag 0x00 for raw data, 0x02 for run length by line, 0x04 for LZSS, 0x08 for deflate
+     * @param compressedData to uncompress. For deflate, the data following the 2 bytes of uncompressed size
+     * @param uncompressedData buffer receiving the uncompressed data, of width * height bytes
+     * @param width width of a line of pixels
+     * @param height number of lines of pixels
+     * @return the number of bytes written in the buffer
+     * @throw Status if the compression is not supported or the data does not fit in the buffer
+     */
+    static qint64 decode(quint8 compressionFlag, const DataView &compressedData, char *uncompressedData,
+                         const uint &width, const uint &height);
+
     /**
      * Encrypt data according to the encryption key given. The same key is
      * used to encrypt and decrypt using a incrementing counter and xor operation
@@ -127,6 +170,22 @@ public:
      */
     static QVector<char> encryptDecrypt(const QVector<char> &data,
                                         QVector<quint8> cryptKey = {0xEA, 0x7B, 0x4E, 0xBD, 0x19, 0xC9, 0x38, 0x99});
+
+private:
+    //**************************************************************************
+    // Methods
+    //**************************************************************************
+    /**
+     * Uncompressed data with a LZSS algorithm into a buffer, grown when full if it is a vector
+     * @param compressedData to uncompress
+     * @param growableData vector owning the buffer, grown geometrically when full. nullptr if the buffer cannot grow
+     * @param uncompressedData buffer receiving the uncompressed data
+     * @param uncompressedSize size of the buffer
+     * @return the number of bytes written in the buffer, the data of growableData if given
+     * @throw Status if the compressed data is truncated or does not fit in the buffer
+     */
+    static qint64 uncompressLZSS(const DataView &compressedData, QVector<char> *growableData, char *uncompressedData,
+                                 qint64 uncompressedSize);
 };
 
 #endif // BSATOOL_COMPRESSION_H
@@ -0,0 +1,66 @@
+#ifndef BSATOOL_CONCURRENTUTILS_H
+#define BSATOOL_CONCURRENTUTILS_H
+
+#include <error/Status.h>
+#include <QMutex>
+#include <QVector>
+#include <QtConcurrent/QtConcurrent>
+
+using namespace std;
+
+/**
+ * Utils class providing helpers to run work on the global thread pool
+ */
+class ConcurrentUtils {
+private:
+    //**************************************************************************
+    // Constructors
+    //**************************************************************************
+    ConcurrentUtils() = default;
+
+public:
+    //**************************************************************************
+    // Static Methods
+    //**************************************************************************
+    /**
+     * Apply a function to each item in parallel and gather the results in the items order. Status cannot cross the
+     * thread pool boundary: the first error met is kept and thrown once all the items are processed
+     * @param items items to process
+     * @param function function giving the result of an item, throwing a Status on error
+     * @param itemName function giving the name of an item, used in the error message
+     * @param errorContext start of the error message
+     * @return the results, in the items order
+     * @throw Status the first error met, with the name of its item
+     */
+    template<typename Result, typename Item, typename Function, typename ItemName>
+    static QVector<Result> blockingMapped(const QVector<Item> &items, Function function, ItemName itemName,
+                                          const QString &errorContext);
+};
+
+//**************************************************************************
+// Definitions
+//**************************************************************************
+template<typename Result, typename Item, typename Function, typename ItemName>
+QVector<Result> ConcurrentUtils::blockingMapped(const QVector<Item> &items, Function function, ItemName itemName,
+                                                const QString &errorContext) {
+    QMutex errorMutex;
+    QString errorMessage;
+    std::function<Result(const Item &item)> guardedFunction = [&](const Item &item) {
+        try {
+            return Result(function(item));
+        } catch (Status &e) {
+            QMutexLocker locker(&errorMutex);
+            if (errorMessage.isEmpty()) {
+                errorMessage = QString("%1 : %2").arg(itemName(item), e.message());
+            }
+            return Result();
+        }
+    };
+    QVector<Result> results = QtConcurrent::blockingMapped<QVector<Result>>(items, guardedFunction);
+    if (!errorMessage.isEmpty()) {
+        throw Status(-1, errorContext + " : " + errorMessage);
+    }
+    return results;
+}
+
+#endif // BSATOOL_CONCURRENTUTILS_H
@@ -0,0 +1,38 @@
+#include <utils/DataView.h>
+
+//**************************************************************************
+// Constructors
+//**************************************************************************
+DataView::DataView(const char *data, qint64 size) : mData(data), mSize(size) {}
+
+DataView::DataView(const QVector<char> &data) : mData(data.constData()), mSize(data.size()) {}
+
+//**************************************************************************
+// Getters/setters
+//**************************************************************************
+const char *DataView::data() const {
+    return mData;
+}
+
+qint64 DataView::size() const {
+    return mSize;
+}
+
+bool DataView::isEmpty() const {
+    return mSize == 0;
+}
+
+const char *DataView::begin() const {
+    return mData;
+}
+
+const char *DataView::end() const {
+    return mData + mSize;
+}
+
+//**************************************************************************
+// Methods
+//**************************************************************************
+QVector<char> DataView::toVector() const {
+    return QVector<char>(begin(), end());
+}
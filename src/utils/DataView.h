@@ -0,0 +1,83 @@
+#ifndef BSATOOL_DATAVIEW_H
+#define BSATOOL_DATAVIEW_H
+
+#include <QVector>
+
+using namespace std;
+
+/**
+ * @brief Read-only view on a contiguous block of bytes
+ *
+ * The view does not own the data it points to: the owner (a memory mapped archive, a QVector...) must outlive the
+ * view. Copying a view never copies the underlying data
+ */
+class DataView {
+public:
+    //**************************************************************************
+    // Constructors
+    //**************************************************************************
+    /**
+     * @brief constructor of an empty view
+     */
+    DataView() = default;
+    /**
+     * @brief constructor of a view on the given data
+     * @param data first byte of the view
+     * @param size number of bytes in the view
+     */
+    DataView(const char *data, qint64 size);
+    /**
+     * @brief constructor of a view on the whole content of a vector. The vector must not be modified while the view
+     * is used
+     * @param data vector to view
+     */
+    explicit DataView(const QVector<char> &data);
+
+    //**************************************************************************
+    // Getters/setters
+    //**************************************************************************
+    /**
+     * @brief first byte of the view
+     */
+    [[nodiscard]] const char *data() const;
+    /**
+     * @brief number of bytes in the view
+     */
+    [[nodiscard]] qint64 size() const;
+    /**
+     * @brief true if the view contains no byte
+     */
+    [[nodiscard]] bool isEmpty() const;
+    /**
+     * @brief iterator on the first byte
+     */
+    [[nodiscard]] const char *begin() const;
+    /**
+     * @brief iterator past the last byte
+     */
+    [[nodiscard]] const char *end() const;
+
+    //**************************************************************************
+    // Methods
+    //**************************************************************************
+    /**
+     * @brief copy the viewed bytes into a new vector
+     * @return the copied data
+     */
+    [[nodiscard]] QVector<char> toVector() const;
+
+private:
+    //**************************************************************************
+    // Attributes
+    //**************************************************************************
+    /**
+     * @brief first byte of the view
+     */
+    const char *mData{nullptr};
+    /**
+     * @brief number of bytes in the view
+     */
+    qint64 mSize{0};
+};
+
+#endif // BSATOOL_DATAVIEW_H
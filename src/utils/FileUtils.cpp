@@ -1,5 +1,10 @@
 #include <utils/FileUtils.h>
 #include <error/Status.h>
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
 
 //**************************************************************************
 // Statics
@@ -18,3 +23,51 @@ QByteArray FileUtils::readDataFromFile(const QString &filePath) {
     }
     return retrievedData;
 }
+
+void FileUtils::writeDataToFile(const QString &filePath, const char *data, qint64 size) {
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        throw Status(-1, QString("Could not open the file in write mode : %1")
+                .arg(filePath));
+    }
+    qint64 bytesWritten = file.write(data, size);
+    file.close();
+    if (bytesWritten < size) {
+        throw Status(-1, QString("Only %1 bytes of %2 written to file %3")
+                .arg(bytesWritten)
+                .arg(size)
+                .arg(filePath));
+    }
+}
+
+void FileUtils::copyData(QIODevice &source, QIODevice &destination, qint64 size, QVector<char> &buffer) {
+    qint64 remainingBytes = size;
+    while (remainingBytes > 0) {
+        qint64 chunkSize = qMin(remainingBytes, qint64(buffer.size()));
+        qint64 bytesRead = source.read(buffer.data(), chunkSize);
+        if (bytesRead != chunkSize) {
+            throw Status(-1, QString("Could not retrieve all the data got %1, expected %2")
+                    .arg(size - remainingBytes + qMax(bytesRead, qint64(0))).arg(size));
+        }
+        qint64 bytesWritten = destination.write(buffer.constData(), chunkSize);
+        if (bytesWritten != chunkSize) {
+            throw Status(-1, QString("Only %1 bytes of %2 written")
+                    .arg(size - remainingBytes + qMax(bytesWritten, qint64(0))).arg(size));
+        }
+        remainingBytes -= chunkSize;
+    }
+}
+
+void FileUtils::syncFile(QFile &file) {
+    if (!file.flush()) {
+        throw Status(-1, QString("Could not flush the file : %1").arg(file.fileName()));
+    }
+#ifdef Q_OS_WIN
+    bool synced = _commit(file.handle()) == 0;
+#else
+    bool synced = fsync(file.handle()) == 0;
+#endif
+    if (!synced) {
+        throw Status(-1, QString("Could not store the file on disk : %1").arg(file.fileName()));
+    }
+}
@@ -3,6 +3,7 @@
 
 #include <QFile>
 #include <QFileInfo>
+#include <QVector>
 
 using namespace std;
 
@@ -28,6 +29,34 @@ public:
      * @throw Status if data is not readable or not able to read it all
      */
     static QByteArray readDataFromFile(const QString &filePath);
+
+    /**
+     * Write data to file, replacing its content if it already exists
+     * @param filePath path to the file to write data to
+     * @param data first byte of the data to write
+     * @param size number of bytes to write
+     * @throw Status if the file cannot be opened in write mode or not all the data could be written
+     */
+    static void writeDataToFile(const QString &filePath, const char *data, qint64 size);
+
+    /**
+     * Copy data from the current position of a device to the current position of another, chunk by chunk through the
+     * given buffer so that the memory used does not depend on the copied size
+     * @param source device to read data from
+     * @param destination device to write data to
+     * @param size number of bytes to copy
+     * @param buffer buffer used for each chunk. Must not be empty
+     * @throw Status if not all the data could be read or written
+     */
+    static void copyData(QIODevice &source, QIODevice &destination, qint64 size, QVector<char> &buffer);
+
+    /**
+     * Flush the written data of an opened file and wait for the system to store it on disk, so that it survives a
+     * crash
+     * @param file opened file to synchronize
+     * @throw Status if the data could not be flushed or stored
+     */
+    static void syncFile(QFile &file);
 };
 
 #endif // BSATOOL_FILEUTILS_H
@@ -0,0 +1,73 @@
+#include <utils/HashUtils.h>
+#include <QtEndian>
+
+//**************************************************************************
+// Static Methods
+//**************************************************************************
+quint64 HashUtils::xxHash64(const char *data, qint64 size, quint64 seed) {
+    const char *current = data;
+    const char *end = data + size;
+    quint64 hash;
+    // Stripes of 32 bytes mixed in 4 accumulators
+    if (size >= 32) {
+        quint64 accumulator1 = seed + PRIME64_1 + PRIME64_2;
+        quint64 accumulator2 = seed + PRIME64_2;
+        quint64 accumulator3 = seed;
+        quint64 accumulator4 = seed - PRIME64_1;
+        const char *lastStripe = end - 32;
+        do {
+            accumulator1 = round(accumulator1, qFromLittleEndian<quint64>(current));
+            accumulator2 = round(accumulator2, qFromLittleEndian<quint64>(current + 8));
+            accumulator3 = round(accumulator3, qFromLittleEndian<quint64>(current + 16));
+            accumulator4 = round(accumulator4, qFromLittleEndian<quint64>(current + 24));
+            current += 32;
+        } while (current <= lastStripe);
+        hash = rotateLeft(accumulator1, 1) + rotateLeft(accumulator2, 7) +
+               rotateLeft(accumulator3, 12) + rotateLeft(accumulator4, 18);
+        hash = mergeRound(hash, accumulator1);
+        hash = mergeRound(hash, accumulator2);
+        hash = mergeRound(hash, accumulator3);
+        hash = mergeRound(hash, accumulator4);
+    } else {
+        hash = seed + PRIME64_5;
+    }
+    hash += quint64(size);
+    // Remaining bytes
+    while (end - current >= 8) {
+        hash ^= round(0, qFromLittleEndian<quint64>(current));
+        hash = rotateLeft(hash, 27) * PRIME64_1 + PRIME64_4;
+        current += 8;
+    }
+    if (end - current >= 4) {
+        hash ^= quint64(qFromLittleEndian<quint32>(current)) * PRIME64_1;
+        hash = rotateLeft(hash, 23) * PRIME64_2 + PRIME64_3;
+        current += 4;
+    }
+    while (current < end) {
+        hash ^= quint64(quint8(*current)) * PRIME64_5;
+        hash = rotateLeft(hash, 11) * PRIME64_1;
+        current++;
+    }
+    // Final avalanche
+    hash ^= hash >> 33;
+    hash *= PRIME64_2;
+    hash ^= hash >> 29;
+    hash *= PRIME64_3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+quint64 HashUtils::rotateLeft(quint64 value, int bitNumber) {
+    return (value << bitNumber) | (value >> (64 - bitNumber));
+}
+
+quint64 HashUtils::round(quint64 accumulator, quint64 lane) {
+    accumulator += lane * PRIME64_2;
+    accumulator = rotateLeft(accumulator, 31);
+    return accumulator * PRIME64_1;
+}
+
+quint64 HashUtils::mergeRound(quint64 hash, quint64 accumulator) {
+    hash ^= round(0, accumulator);
+    return hash * PRIME64_1 + PRIME64_4;
+}
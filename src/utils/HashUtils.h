@@ -0,0 +1,58 @@
+#ifndef BSATOOL_HASHUTILS_H
+#define BSATOOL_HASHUTILS_H
+
+#include <QtGlobal>
+
+using namespace std;
+
+/**
+ * Utils class providing fast non-cryptographic hash functions
+ */
+class HashUtils {
+private:
+    //**************************************************************************
+    // Constructors
+    //**************************************************************************
+    HashUtils() = default;
+
+public:
+    //**************************************************************************
+    // Static Methods
+    //**************************************************************************
+    /**
+     * Compute the 64 bits xxHash (XXH64) of the given data
+     * @param data first byte to hash
+     * @param size byte number to hash
+     * @param seed seed of the hash
+     * @return the hash, identical to the reference XXH64 implementation
+     */
+    static quint64 xxHash64(const char *data, qint64 size, quint64 seed = 0);
+
+private:
+    //**************************************************************************
+    // Statics
+    //**************************************************************************
+    static const quint64 PRIME64_1 = 0x9E3779B185EBCA87ULL;
+    static const quint64 PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+    static const quint64 PRIME64_3 = 0x165667B19E3779F9ULL;
+    static const quint64 PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+    static const quint64 PRIME64_5 = 0x27D4EB2F165667C5ULL;
+
+    //**************************************************************************
+    // Static Methods
+    //**************************************************************************
+    /**
+     * Rotate the bits of a value to the left
+     */
+    static quint64 rotateLeft(quint64 value, int bitNumber);
+    /**
+     * Mix a 64 bits lane into an accumulator
+     */
+    static quint64 round(quint64 accumulator, quint64 lane);
+    /**
+     * Merge an accumulator into the hash
+     */
+    static quint64 mergeRound(quint64 hash, quint64 accumulator);
+};
+
+#endif // BSATOOL_HASHUTILS_H
@@ -1,4 +1,5 @@
 #include <utils/HuffmanTree.h>
+#include <algorithm>
 
 using namespace std;
 
@@ -32,6 +33,7 @@ HuffmanTree::HuffmanTree() {
 void HuffmanTree::resetTreeAtFreqTooHigh() {
     // Reset because total freq too high on root
     if (mFreq[626] == 0x8000) {
+        mLookUpTableValid = false;
         // gathering leaf at the beginning and halving their freq
         quint16 nextLeafFreeIndex = 0;
         for (quint16 currentNode(0); currentNode < 627; currentNode++) {
@@ -90,6 +92,10 @@ void HuffmanTree::increaseFreqLeaf(const quint16 &leaf) {
                 LastNodeWithLowerFreq++;
             }
             LastNodeWithLowerFreq--;
+            // the lookup table is outdated if it goes through the switched nodes
+            if (mLookUpNodes[currentNode] || mLookUpNodes[LastNodeWithLowerFreq]) {
+                mLookUpTableValid = false;
+            }
             // switching nodes and their subtrees
             // nodes freq
             mFreq[currentNode] = mFreq[LastNodeWithLowerFreq];
@@ -117,14 +123,47 @@ void HuffmanTree::increaseFreqLeaf(const quint16 &leaf) {
     } while (currentNode != 0);
 }
 
+void HuffmanTree::buildLookUpTable() {
+    mLookUpNodes.fill(false);
+    mLookUpNodes[626] = true;
+    fillLookUpTable(mTree[626], 1, 0);
+    mLookUpTableValid = true;
+}
+
+void HuffmanTree::fillLookUpTable(const quint16 &leftChild, const quint8 &depth, const quint16 &prefix) {
+    for (quint16 childChoice(0); childChoice < 2; childChoice++) {
+        const quint16 child = leftChild + childChoice;
+        const quint16 childPrefix = (prefix << 1u) | childChoice;
+        mLookUpNodes[child] = true;
+        if (mTree[child] >= 627 || depth == LOOKUP_BITS) {
+            // all the bits values starting with this path lead to this child
+            const quint8 nbFreeBits = LOOKUP_BITS - depth;
+            const LookUpEntry entry{mTree[child], depth};
+            std::fill_n(mLookUpTable.begin() + (childPrefix << nbFreeBits), 1u << nbFreeBits, entry);
+        } else {
+            fillLookUpTable(mTree[child], depth + 1, childPrefix);
+        }
+    }
+}
+
 quint16 HuffmanTree::findLeaf(BitsReader &bitsReader) {
-    // searching leaf in tree from input
-    quint16 leaf = mTree[626];
+    if (!mLookUpTableValid) {
+        buildLookUpTable();
+    }
+    // resolving the top levels of the tree at once, getBits ensuring eight usable bits
+    const LookUpEntry &entry = mLookUpTable[bitsReader.getBits() >> (NB_BITS_IN_BYTE - LOOKUP_BITS)];
+    bitsReader.removeBits(entry.length);
+    // searching leaf in the deeper levels from input, eight bits at a time
+    quint16 leaf = entry.node;
     while (leaf < 627) {
-        quint8 bits = bitsReader.getBits();
-        bitsReader.removeBits(1);
-        quint16 childChoice = bits >> 7u;
-        leaf = mTree[leaf + childChoice];
+        const quint8 bits = bitsReader.getBits();
+        quint8 usedBits = 0;
+        while (leaf < 627 && usedBits < NB_BITS_IN_BYTE) {
+            quint16 childChoice = (bits >> (7u - usedBits)) & 0x01u;
+            leaf = mTree[leaf + childChoice];
+            usedBits++;
+        }
+        bitsReader.removeBits(usedBits);
     }
     resetTreeAtFreqTooHigh();
     increaseFreqLeaf(leaf);
@@ -132,18 +171,20 @@ quint16 HuffmanTree::findLeaf(BitsReader &bitsReader) {
 }
 
 void HuffmanTree::writePathForLeaf(BitsWriter &bitsWriter, const quint16 &leaf) {
-    deque<quint16> path;
+    // building the code while climbing up the tree : the first direction found is the last bit of the path
+    quint64 code = 0;
+    quint8 codeLength = 0;
     quint16 node = mRevTree[leaf];
-    quint8 left = 0;
-    quint8 right = 0x80u;
     while (node < 626) {
         quint16 parent = mRevTree[node];
-        path.push_front(mTree[parent] == node ? left : right);
+        // 0 for the left child, 1 for the right one
+        if (mTree[parent] != node) {
+            code |= quint64(1) << codeLength;
+        }
+        codeLength++;
         node = parent;
     }
-    for (auto direction : path) {
-        bitsWriter.addBits(direction, 1u);
-    }
+    bitsWriter.addLowBits(code, codeLength);
     resetTreeAtFreqTooHigh();
     increaseFreqLeaf(leaf);
 }
@@ -37,6 +37,32 @@ using namespace std;
  */
 class HuffmanTree {
 private:
+    //**************************************************************************
+    // Types
+    //**************************************************************************
+    /**
+     * @brief result of a walk from the root using LOOKUP_BITS bits
+     */
+    struct LookUpEntry {
+        /**
+         * @brief the found leaf's unprocessed value, or the left child index of the node reached
+         */
+        quint16 node;
+        /**
+         * @brief number of bits used by the walk
+         */
+        quint8 length;
+    };
+
+    //**************************************************************************
+    // Statics
+    //**************************************************************************
+    /**
+     * @brief number of bits, and so of tree levels, resolved at once by the lookup table. Deeper tables are outdated
+     * by most of the searches, the top nodes of an adaptive tree being often switched
+     */
+    const static quint8 LOOKUP_BITS = 5;
+
     //**************************************************************************
     // Methods
     //**************************************************************************
@@ -53,6 +79,19 @@ private:
      */
     void increaseFreqLeaf(const quint16 &leaf);
 
+    /**
+     * rebuild the lookup table from the current tree, marking the nodes read to build it
+     */
+    void buildLookUpTable();
+
+    /**
+     * fill the lookup table for the subtree of the given children
+     * @param leftChild index of the left child of the subtree root
+     * @param depth depth of the children
+     * @param prefix bits of the path from the root to the subtree root
+     */
+    void fillLookUpTable(const quint16 &leftChild, const quint8 &depth, const quint16 &prefix);
+
     //**************************************************************************
     // Attributes
     //**************************************************************************
@@ -75,6 +114,19 @@ private:
      * has a initial frequency of 314 (the number of leaves).
      */
     array<quint16, 628> mFreq{};
+    /**
+     * @brief result of the walk from the root for each value of the next LOOKUP_BITS bits
+     */
+    array<LookUpEntry, 1u << LOOKUP_BITS> mLookUpTable{};
+    /**
+     * @brief true for the nodes of mTree read to build the lookup table : the table is outdated as soon as one of
+     * them changes
+     */
+    array<bool, 627> mLookUpNodes{};
+    /**
+     * @brief true if the lookup table matches the tree, the table being rebuilt on the next search otherwise
+     */
+    bool mLookUpTableValid{false};
 
 public:
     //**************************************************************************
@@ -89,7 +141,8 @@ public:
     // Methods
     //**************************************************************************
     /**
-     * Navigate the tree from the root using bits from given reader. It stops when a leaf is found. The found leaf's
+     * Navigate the tree from the root using bits from given reader. It stops when a leaf is found. The top levels of
+     * the tree are resolved at once through a lookup table, the deeper ones eight bits at a time. The found leaf's
      * frequency is increased by one, the tree resets if total frequency too high and the tree is processed to remained
      * ordered.
      * @param bitsReader Reader from which get the bits used to navigate the tree (0 = left child, 1 = right child)
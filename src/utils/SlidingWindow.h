@@ -67,11 +67,12 @@ public:
     //**************************************************************************
     /**
      * Search for a duplicate in the sliding window
-     * @param uncompressDataDeque data from which read the ongoing data to insert
+     * @param uncompressData ongoing data to insert, read in place
+     * @param uncompressSize number of elements remaining in uncompressData
      * @param max_duplicate_length max length for a duplicate to copy
      * @return the search result
      */
-    DuplicateSearchResult searchDuplicateInSlidingWindow(const deque<sw_type> &uncompressDataDeque,
+    DuplicateSearchResult searchDuplicateInSlidingWindow(const sw_type *uncompressData, size_t uncompressSize,
                                                          size_t max_duplicate_length);
 
     /**
@@ -124,20 +125,24 @@ private:
     //**************************************************************************
     /**
      * Search for a duplicate in the possibly soon rewritten part of the sliding window
-     * @param uncompressDataDeque data from which read the ongoing data to insert
+     * @param uncompressData ongoing data to insert, read in place
+     * @param uncompressSize number of elements remaining in uncompressData
      * @param max_duplicate_length max length for a duplicate to copy
      * @return the search result
      */
-    DuplicateSearchResult searchDuplicateInSlidingWindowLookAheadOnly(const deque<sw_type> &uncompressDataDeque,
+    DuplicateSearchResult searchDuplicateInSlidingWindowLookAheadOnly(const sw_type *uncompressData,
+                                                                      size_t uncompressSize,
                                                                       size_t max_duplicate_length);
 
     /**
      * Search for a duplicate in the sliding window, avoiding the last max_duplicate_length bytes of the window
-     * @param uncompressDataDeque data from which read the ongoing data to insert
+     * @param uncompressData ongoing data to insert, read in place
+     * @param uncompressSize number of elements remaining in uncompressData
      * @param max_duplicate_length max length for a duplicate to copy
      * @return the search result
      */
-    DuplicateSearchResult searchDuplicateInSlidingWindowNoLookAhead(const deque<sw_type> &uncompressDataDeque,
+    DuplicateSearchResult searchDuplicateInSlidingWindowNoLookAhead(const sw_type *uncompressData,
+                                                                    size_t uncompressSize,
                                                                     size_t max_duplicate_length);
 };
 
@@ -193,10 +198,10 @@ size_t SlidingWindow<sw_type, sw_size>::getStandardEquivalentIndex(const size_t
 
 template<typename sw_type, size_t sw_size>
 typename SlidingWindow<sw_type, sw_size>::DuplicateSearchResult SlidingWindow<sw_type, sw_size>::searchDuplicateInSlidingWindowLookAheadOnly(
-        const deque<sw_type> &uncompressDataDeque, const size_t max_duplicate_length) {
+        const sw_type *uncompressData, const size_t uncompressSize, const size_t max_duplicate_length) {
     // search longest possible considering max duplicate length and remaining uncompressed data
     quint8 max_possible_duplicate_length(
-            uncompressDataDeque.size() < max_duplicate_length ? uncompressDataDeque.size() : max_duplicate_length);
+            uncompressSize < max_duplicate_length ? uncompressSize : max_duplicate_length);
     // building preview window using current data and future one
     QVector<char> snapshotFutureWindow;
     // end of current buffer
@@ -205,11 +210,11 @@ typename SlidingWindow<sw_type, sw_size>::DuplicateSearchResult SlidingWindow<sw
     }
     // data that will next be written in buffer
     for (size_t i(0); i < max_possible_duplicate_length - 1; ++i) {
-        snapshotFutureWindow.push_back(uncompressDataDeque[i]);
+        snapshotFutureWindow.push_back(uncompressData[i]);
     }
     // searching for duplicate
     DuplicateSearchResult result = {0, 0};
-    const char &nextUncompressedByte = uncompressDataDeque.front();
+    const char &nextUncompressedByte = uncompressData[0];
     for (int i(0); i < max_duplicate_length && result.length < max_possible_duplicate_length; ++i) {
         // found start for a match
         if (nextUncompressedByte == snapshotFutureWindow[i]) {
@@ -217,7 +222,7 @@ typename SlidingWindow<sw_type, sw_size>::DuplicateSearchResult SlidingWindow<sw
             quint8 tempLength(1);
             // computing while not the longest length and available data
             while (tempLength < max_possible_duplicate_length &&
-                   snapshotFutureWindow[i + tempLength] == uncompressDataDeque[tempLength]) {
+                   snapshotFutureWindow[i + tempLength] == uncompressData[tempLength]) {
                 tempLength++;
             }
             // writing result if longer
@@ -232,15 +237,15 @@ typename SlidingWindow<sw_type, sw_size>::DuplicateSearchResult SlidingWindow<sw
 
 template<typename sw_type, size_t sw_size>
 typename SlidingWindow<sw_type, sw_size>::DuplicateSearchResult SlidingWindow<sw_type, sw_size>::searchDuplicateInSlidingWindowNoLookAhead(
-        const deque<sw_type> &uncompressDataDeque, const size_t max_duplicate_length) {
+        const sw_type *uncompressData, const size_t uncompressSize, const size_t max_duplicate_length) {
     DuplicateSearchResult result = {0, 0};
     quint8 tempLength;
     quint16 tempStartIndex;
     // If not at least 3 elements in incoming data, stop. Only duplicate of length 3 or more are searched
-    if (uncompressDataDeque.size() >= 3) {
+    if (uncompressSize >= 3) {
         if (mUseDictionary) {
-            auto threeElemDuplicIdx = mDuplicateDictionary.values({uncompressDataDeque[0], uncompressDataDeque[1], uncompressDataDeque[2]});
-            const char &nextUncompressedByte = uncompressDataDeque.front();
+            auto threeElemDuplicIdx = mDuplicateDictionary.values({uncompressData[0], uncompressData[1], uncompressData[2]});
+            const char &nextUncompressedByte = uncompressData[0];
             for (int i = 0; i < threeElemDuplicIdx.size() && result.length < max_duplicate_length; ++i) {
                 tempStartIndex = threeElemDuplicIdx.at(i);
                 // If not idx that should be search in lookahead
@@ -249,9 +254,9 @@ typename SlidingWindow<sw_type, sw_size>::DuplicateSearchResult SlidingWindow<sw
                     if (nextUncompressedByte == readAtIndex(tempStartIndex)) {
                         tempLength = 1;
                         // computing length for the found match, while checking if enough data available for it
-                        while (tempLength < uncompressDataDeque.size() &&
+                        while (tempLength < uncompressSize &&
                                tempLength < max_duplicate_length &&
-                               uncompressDataDeque[tempLength] == readAtIndex(tempStartIndex + tempLength)) {
+                               uncompressData[tempLength] == readAtIndex(tempStartIndex + tempLength)) {
                             tempLength++;
                         }
                         // keeping only if longer than a previous one
@@ -265,16 +270,16 @@ typename SlidingWindow<sw_type, sw_size>::DuplicateSearchResult SlidingWindow<sw
         } else {
             // searching a first byte match until longest found or all window searched
             // starting at offset 1 from current position to avoid the window current index
-            const char &nextUncompressedByte = uncompressDataDeque.front();
+            const char &nextUncompressedByte = uncompressData[0];
             for (int i = 1; i < 4096 - max_duplicate_length && result.length < max_duplicate_length; ++i) {
                 tempStartIndex = getStandardEquivalentIndex(getMCurrentInsertPosition() + i);
                 // Found a possible match
                 if (nextUncompressedByte == readAtIndex(tempStartIndex)) {
                     tempLength = 1;
                     // computing length for the found match, while checking if enough data available for it
-                    while (tempLength < uncompressDataDeque.size() &&
+                    while (tempLength < uncompressSize &&
                            tempLength < max_duplicate_length &&
-                           uncompressDataDeque[tempLength] == readAtIndex(tempStartIndex + tempLength)) {
+                           uncompressData[tempLength] == readAtIndex(tempStartIndex + tempLength)) {
                         tempLength++;
                     }
                     // keeping only if longer than a previous one
@@ -290,17 +295,18 @@ typename SlidingWindow<sw_type, sw_size>::DuplicateSearchResult SlidingWindow<sw
 }
 
 template<typename sw_type, size_t sw_size>
-typename SlidingWindow<sw_type, sw_size>::DuplicateSearchResult SlidingWindow<sw_type, sw_size>::searchDuplicateInSlidingWindow(const deque<sw_type> &uncompressDataDeque,
+typename SlidingWindow<sw_type, sw_size>::DuplicateSearchResult SlidingWindow<sw_type, sw_size>::searchDuplicateInSlidingWindow(const sw_type *uncompressData,
+                                                                                                                                const size_t uncompressSize,
                                                                                                                                 const size_t max_duplicate_length) {
     // searching for an ongoing duplicate using the possibly rewritten part of the window
-    const DuplicateSearchResult lookAhead = searchDuplicateInSlidingWindowLookAheadOnly(uncompressDataDeque,
+    const DuplicateSearchResult lookAhead = searchDuplicateInSlidingWindowLookAheadOnly(uncompressData, uncompressSize,
                                                                                         max_duplicate_length);
     DuplicateSearchResult noLookAhead = {0, 0};
     // not longest found
     if (lookAhead.length < max_duplicate_length) {
         // Search through buffer in case there is a longer duplicate to copy avoiding the possibly
         // rewritten section already search before
-        noLookAhead = searchDuplicateInSlidingWindowNoLookAhead(uncompressDataDeque, max_duplicate_length);
+        noLookAhead = searchDuplicateInSlidingWindowNoLookAhead(uncompressData, uncompressSize, max_duplicate_length);
     }
     return lookAhead.length > noLookAhead.length ? lookAhead : noLookAhead;
 }
@@ -0,0 +1,102 @@
+#include <QtTest/QtTest>
+#include <bsa/ArchiveDiffTest.h>
+#include <bsa/ArchiveDiff.h>
+#include <bsa/BsaArchiveTest.h>
+
+void ArchiveDiffTest::initTestCase() {
+    QVERIFY(mTemporaryDir.isValid());
+    mOldArchivePath = mTemporaryDir.filePath(QStringLiteral("OLD.BSA"));
+    BsaArchiveTest::writeSyntheticArchive(mOldArchivePath, 50, 64);
+    // New version: F00003 changed with the same size, F00004 changed with another size, F00005 removed, NEW added
+    QDir looseFolder(mTemporaryDir.path());
+    QVERIFY(looseFolder.mkpath(QStringLiteral("loose")));
+    QVERIFY(looseFolder.cd(QStringLiteral("loose")));
+    BsaArchiveTest::writeLooseFile(looseFolder.filePath(QStringLiteral("F00003.DAT")), 64, 'x');
+    BsaArchiveTest::writeLooseFile(looseFolder.filePath(QStringLiteral("F00004.DAT")), 10, 'y');
+    BsaArchiveTest::writeLooseFile(looseFolder.filePath(QStringLiteral("NEW.DAT")), 5, 'n');
+    BsaArchive archive;
+    archive.openArchive(mOldArchivePath);
+    archive.addOrUpdateFiles({looseFolder.filePath(QStringLiteral("F00003.DAT")),
+                              looseFolder.filePath(QStringLiteral("F00004.DAT")),
+                              looseFolder.filePath(QStringLiteral("NEW.DAT"))});
+    archive.deleteFile(archive.getFile(QStringLiteral("F00005.DAT")));
+    mNewArchivePath = mTemporaryDir.filePath(QStringLiteral("NEW.BSA"));
+    archive.saveArchive(mNewArchivePath);
+}
+
+void ArchiveDiffTest::testCompare() {
+    BsaArchive oldArchive;
+    oldArchive.openArchive(mOldArchivePath);
+    BsaArchive newArchive;
+    newArchive.openArchive(mNewArchivePath, BsaArchive::MEMORY_MAPPED);
+
+    qInfo("Should find the added, removed and changed files");
+    ArchiveDiff diff = ArchiveDiff::compare(oldArchive, newArchive);
+    QCOMPARE(diff.addedFiles().size(), 1);
+    QCOMPARE(diff.addedFiles().first().fileName(), QStringLiteral("NEW.DAT"));
+    QCOMPARE(diff.removedFiles().size(), 1);
+    QCOMPARE(diff.removedFiles().first().fileName(), QStringLiteral("F00005.DAT"));
+    QCOMPARE(diff.changedFiles().size(), 2);
+    QCOMPARE(diff.changedFiles().at(0).fileName(), QStringLiteral("F00003.DAT"));
+    QCOMPARE(diff.changedFiles().at(1).fileName(), QStringLiteral("F00004.DAT"));
+
+    qInfo("Should find no difference between identical archives");
+    QVERIFY(ArchiveDiff::compare(oldArchive, oldArchive).isEmpty());
+}
+
+void ArchiveDiffTest::testExportAndApplyPatch() {
+    BsaArchive oldArchive;
+    oldArchive.openArchive(mOldArchivePath);
+    BsaArchive newArchive;
+    newArchive.openArchive(mNewArchivePath);
+    QDir patchFolder(mTemporaryDir.path());
+    QVERIFY(patchFolder.mkpath(QStringLiteral("patch")));
+    QVERIFY(patchFolder.cd(QStringLiteral("patch")));
+
+    qInfo("Should export only the added and changed files");
+    ArchiveDiff::compare(oldArchive, newArchive).exportPatch(newArchive, patchFolder.path());
+    QCOMPARE(patchFolder.entryList(QDir::Files).size(), 4);
+
+    qInfo("Should turn the old archive into the new one");
+    ArchiveDiff::applyPatch(oldArchive, patchFolder.path());
+    QVERIFY(ArchiveDiff::compare(oldArchive, newArchive).isEmpty());
+    QString patchedPath = mTemporaryDir.filePath(QStringLiteral("PATCHED.BSA"));
+    oldArchive.saveArchive(patchedPath);
+    QVERIFY(ArchiveDiff::compare(oldArchive, newArchive).isEmpty());
+
+    qInfo("Should refuse a patch not matching the archive");
+    quint16 fileNumber = oldArchive.fileNumber();
+    QVERIFY_EXCEPTION_THROWN(ArchiveDiff::applyPatch(oldArchive, patchFolder.path()), Status);
+    QCOMPARE(oldArchive.fileNumber(), fileNumber);
+    QVERIFY(!oldArchive.isModified());
+}
+
+void ArchiveDiffTest::testApplyMismatchingPatch() {
+    BsaArchive archive;
+    archive.openArchive(mOldArchivePath);
+    const QVector<BsaFile> originalFiles = archive.getFiles();
+    QDir patchFolder(mTemporaryDir.path());
+    QVERIFY(patchFolder.mkpath(QStringLiteral("mismatch")));
+    QVERIFY(patchFolder.cd(QStringLiteral("mismatch")));
+    BsaArchiveTest::writeLooseFile(patchFolder.filePath(QStringLiteral("F00001.DAT")), 8, 'a');
+    BsaArchiveTest::writeLooseFile(patchFolder.filePath(QStringLiteral("MISSING.DAT")), 8, 'c');
+    auto writeManifest = [&patchFolder](const QByteArray &manifest) {
+        QFile manifestFile(patchFolder.filePath(ArchiveDiff::PATCH_MANIFEST_NAME));
+        QVERIFY(manifestFile.open(QIODevice::WriteOnly | QIODevice::Truncate));
+        QCOMPARE(manifestFile.write(manifest), qint64(manifest.size()));
+    };
+
+    qInfo("Should refuse to add a file already in the archive");
+    writeManifest("C F00002.DAT\nA F00001.DAT\n");
+    BsaArchiveTest::writeLooseFile(patchFolder.filePath(QStringLiteral("F00002.DAT")), 8, 'b');
+    QVERIFY_EXCEPTION_THROWN(ArchiveDiff::applyPatch(archive, patchFolder.path()), Status);
+    QVERIFY(archive.getFiles() == originalFiles);
+    QVERIFY(!archive.isModified());
+
+    qInfo("Should refuse to change a file not in the archive");
+    writeManifest("A NEW.DAT\nC MISSING.DAT\n");
+    BsaArchiveTest::writeLooseFile(patchFolder.filePath(QStringLiteral("NEW.DAT")), 8, 'n');
+    QVERIFY_EXCEPTION_THROWN(ArchiveDiff::applyPatch(archive, patchFolder.path()), Status);
+    QVERIFY(archive.getFiles() == originalFiles);
+    QVERIFY(!archive.isModified());
+}
@@ -0,0 +1,45 @@
+#ifndef BSATOOL_ARCHIVEDIFFTEST_H
+#define BSATOOL_ARCHIVEDIFFTEST_H
+
+#include <QObject>
+#include <QTemporaryDir>
+
+class ArchiveDiffTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    /**
+     * @brief create the two versions of the archive used by the tests
+     */
+    void initTestCase();
+    /**
+     * @brief test the comparison of two archives
+     */
+    void testCompare();
+    /**
+     * @brief test exporting a patch and applying it to the old archive
+     */
+    void testExportAndApplyPatch();
+    /**
+     * @brief test the refusal of a patch whose added or changed files do not match the archive
+     */
+    void testApplyMismatchingPatch();
+
+private:
+    /**
+     * @brief folder containing the test archives
+     */
+    QTemporaryDir mTemporaryDir{};
+    /**
+     * @brief path to the old version of the archive
+     */
+    QString mOldArchivePath{};
+    /**
+     * @brief path to the new version of the archive
+     */
+    QString mNewArchivePath{};
+};
+
+
+#endif //BSATOOL_ARCHIVEDIFFTEST_H
@@ -0,0 +1,80 @@
+#include <QtTest/QtTest>
+#include <bsa/ArchiveIndexTest.h>
+#include <bsa/ArchiveIndex.h>
+#include <bsa/BsaArchiveTest.h>
+#include <utils/FileUtils.h>
+#include <utils/HashUtils.h>
+
+void ArchiveIndexTest::initTestCase() {
+    QVERIFY(mTemporaryDir.isValid());
+    // Files i, i + 256 and i + 512 have the same data
+    mArchivePath = mTemporaryDir.filePath(QStringLiteral("DUPLICATES.BSA"));
+    BsaArchiveTest::writeSyntheticArchive(mArchivePath, 600, 64);
+}
+
+void ArchiveIndexTest::testXxHash64() {
+    qInfo("Should give the reference XXH64 results");
+    QCOMPARE(HashUtils::xxHash64("", 0), quint64(0xEF46DB3751D8E999ULL));
+    QCOMPARE(HashUtils::xxHash64("a", 1), quint64(0xD24EC4F1A98C6E5BULL));
+    QCOMPARE(HashUtils::xxHash64("abc", 3), quint64(0x44BC2CF5AD770999ULL));
+    QCOMPARE(HashUtils::xxHash64("message digest", 14), quint64(0x066ED728FCEEB3BEULL));
+    QCOMPARE(HashUtils::xxHash64("abcdefghijklmnopqrstuvwxyz", 26), quint64(0xCFE1F278FA89835CULL));
+}
+
+void ArchiveIndexTest::testDuplicateGroups() {
+    for (const auto openFlags : {BsaArchive::OpenFlags(BsaArchive::NO_OPEN_FLAG),
+                                 BsaArchive::OpenFlags(BsaArchive::MEMORY_MAPPED)}) {
+        BsaArchive archive;
+        archive.openArchive(mArchivePath, openFlags);
+        ArchiveIndex index(archive);
+
+        qInfo("Should group the identical files");
+        QVector<QVector<BsaFile>> groups = index.getDuplicateGroups();
+        QCOMPARE(groups.size(), 256);
+        QCOMPARE(groups.first().size(), 3);
+        QCOMPARE(groups.first().at(0).fileName(), QStringLiteral("F00000.DAT"));
+        QCOMPARE(groups.first().at(1).fileName(), QStringLiteral("F00256.DAT"));
+        QCOMPARE(groups.first().at(2).fileName(), QStringLiteral("F00512.DAT"));
+        QCOMPARE(groups.last().size(), 2);
+        QCOMPARE(ArchiveIndex::getWastedBytes(groups), qint64(600 - 256) * 64);
+
+        qInfo("Should hash updated files from their external file");
+        QVector<char> data = archive.getFileData(archive.getFile(QStringLiteral("F00001.DAT")));
+        QString updatePath = mTemporaryDir.filePath(QStringLiteral("F00002.DAT"));
+        FileUtils::writeDataToFile(updatePath, data.constData(), data.size());
+        archive.addOrUpdateFile(updatePath);
+        groups = index.getDuplicateGroups();
+        QCOMPARE(groups.size(), 256);
+        QCOMPARE(groups.at(1).size(), 4);
+        QCOMPARE(groups.at(1).at(1).fileName(), QStringLiteral("F00002.DAT"));
+        QCOMPARE(index.getHash(archive.getFile(QStringLiteral("F00002.DAT"))),
+                 index.getHash(archive.getFile(QStringLiteral("F00001.DAT"))));
+    }
+}
+
+void ArchiveIndexTest::testHashCache() {
+    BsaArchive archive;
+    archive.openArchive(mArchivePath);
+    ArchiveIndex index(archive);
+
+    qInfo("Should cache the hashes of the archive files");
+    quint64 hash = index.getHash(archive.getFile(QStringLiteral("F00010.DAT")));
+    QCOMPARE(index.cachedHashNumber(), 1);
+    QCOMPARE(index.getHash(archive.getFile(QStringLiteral("F00266.DAT"))), hash);
+    QCOMPARE(index.cachedHashNumber(), 2);
+    QVERIFY_EXCEPTION_THROWN(index.getHash(BsaFile(1, 2, QStringLiteral("MISSING.DAT"))), Status);
+
+    qInfo("Should only forget the hashes of the changed files");
+    const QString looseFilePath = mTemporaryDir.filePath(QStringLiteral("F00010.DAT"));
+    BsaArchiveTest::writeLooseFile(looseFilePath, 64, 'u');
+    archive.addOrUpdateFile(looseFilePath);
+    QCOMPARE(index.cachedHashNumber(), 1);
+    QCOMPARE(index.getHash(archive.getFile(QStringLiteral("F00266.DAT"))), hash);
+    QCOMPARE(index.cachedHashNumber(), 1);
+    archive.deleteFile(archive.getFile(QStringLiteral("F00001.DAT")));
+    QCOMPARE(index.cachedHashNumber(), 1);
+
+    qInfo("Should forget the hashes when the archive files list is replaced");
+    archive.closeArchive();
+    QCOMPARE(index.cachedHashNumber(), 0);
+}
@@ -0,0 +1,41 @@
+#ifndef BSATOOL_ARCHIVEINDEXTEST_H
+#define BSATOOL_ARCHIVEINDEXTEST_H
+
+#include <QObject>
+#include <QTemporaryDir>
+
+class ArchiveIndexTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    /**
+     * @brief create the synthetic archive used by the tests
+     */
+    void initTestCase();
+    /**
+     * @brief test the hash against the reference implementation results
+     */
+    void testXxHash64();
+    /**
+     * @brief test the detection of identical files
+     */
+    void testDuplicateGroups();
+    /**
+     * @brief test the hashes cache
+     */
+    void testHashCache();
+
+private:
+    /**
+     * @brief folder containing the test archive
+     */
+    QTemporaryDir mTemporaryDir{};
+    /**
+     * @brief path to the test archive
+     */
+    QString mArchivePath{};
+};
+
+
+#endif //BSATOOL_ARCHIVEINDEXTEST_H
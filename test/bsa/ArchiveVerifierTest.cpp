@@ -0,0 +1,85 @@
+#include <QtTest/QtTest>
+#include <bsa/ArchiveVerifierTest.h>
+#include <bsa/ArchiveVerifier.h>
+#include <bsa/BsaArchiveBuilder.h>
+#include <bsa/BsaArchiveTest.h>
+#include <bsa/DecodeCacheTest.h>
+
+void ArchiveVerifierTest::initTestCase() {
+    QVERIFY(mTemporaryDir.isValid());
+}
+
+void ArchiveVerifierTest::testVerifyArchive() {
+    QDir sourceFolder(mTemporaryDir.path());
+    QVERIFY(sourceFolder.mkpath(QStringLiteral("verify")));
+    QVERIFY(sourceFolder.cd(QStringLiteral("verify")));
+    DecodeCacheTest::writeStripesImg(sourceFolder.filePath(QStringLiteral("GOOD.IMG")), 32, 16, 0);
+    BsaArchiveTest::writeLooseFile(sourceFolder.filePath(QStringLiteral("BAD.IMG")), 5, 'b');
+    BsaArchiveTest::writeLooseFile(sourceFolder.filePath(QStringLiteral("RAW.IMG")), 16 * 8, 'r');
+    BsaArchiveTest::writeLooseFile(sourceFolder.filePath(QStringLiteral("OTHER.DAT")), 10, 'o');
+    BsaArchiveBuilder builder;
+    builder.addDirectory(sourceFolder.path());
+    QString archivePath = mTemporaryDir.filePath(QStringLiteral("VERIFY.BSA"));
+    builder.build(archivePath);
+    BsaArchive archive;
+    archive.openArchive(archivePath);
+
+    qInfo("Should report each file in the files list order");
+    ArchiveVerifier::Report report = ArchiveVerifier::verifyArchive(archive, ArchiveConfiguration());
+    QCOMPARE(report.entries.size(), 4);
+    QCOMPARE(report.entries.at(0).file.fileName(), QStringLiteral("BAD.IMG"));
+    QCOMPARE(report.entries.at(1).file.fileName(), QStringLiteral("GOOD.IMG"));
+    QCOMPARE(report.entries.at(1).status.code(), 0);
+    QVERIFY(report.entries.at(1).decoded);
+    QCOMPARE(report.entries.at(2).status.code(), 0);
+    QVERIFY(!report.entries.at(2).decoded);
+    QVERIFY(report.elapsedNanoseconds > 0);
+
+    qInfo("Should report the files which cannot be decoded");
+    QVERIFY(!report.isValid());
+    QVector<ArchiveVerifier::EntryReport> failures = report.failures();
+    QCOMPARE(failures.size(), 2);
+    QCOMPARE(failures.at(0).file.fileName(), QStringLiteral("BAD.IMG"));
+    QVERIFY(failures.at(0).status.message().contains(QStringLiteral("BAD.IMG")));
+    // Without configuration, the IMG without header is read as if it had one
+    QCOMPARE(failures.at(1).file.fileName(), QStringLiteral("RAW.IMG"));
+
+    qInfo("Should decode the IMG files without header described by the configuration");
+    ArchiveConfiguration configuration;
+    FileConfiguration rawConfiguration;
+    rawConfiguration.setFilename(QStringLiteral("RAW.IMG"));
+    rawConfiguration.setNoHeader(true);
+    rawConfiguration.setCustomSize(true);
+    rawConfiguration.setWidth(16);
+    rawConfiguration.setHeight(8);
+    configuration.getFiles().append(rawConfiguration);
+    report = ArchiveVerifier::verifyArchive(archive, configuration);
+    QCOMPARE(report.failures().size(), 1);
+    QCOMPARE(report.entries.at(3).status.code(), 0);
+
+    qInfo("Should refuse a closed archive");
+    archive.closeArchive();
+    QVERIFY_EXCEPTION_THROWN(ArchiveVerifier::verifyArchive(archive, configuration), Status);
+}
+
+void ArchiveVerifierTest::benchmarkVerifyArchive() {
+    QDir sourceFolder(mTemporaryDir.path());
+    QVERIFY(sourceFolder.mkpath(QStringLiteral("many")));
+    QVERIFY(sourceFolder.cd(QStringLiteral("many")));
+    for (int i(0); i < 500; i++) {
+        DecodeCacheTest::writeStripesImg(sourceFolder.filePath(QString("I%1.IMG").arg(i, 5, 10, QChar('0'))),
+                                         128, 128, char(i));
+    }
+    BsaArchiveBuilder builder;
+    builder.addDirectory(sourceFolder.path());
+    builder.setImgRecompression(true);
+    QString archivePath = mTemporaryDir.filePath(QStringLiteral("MANYIMG.BSA"));
+    builder.build(archivePath);
+    BsaArchive archive;
+    archive.openArchive(archivePath);
+    ArchiveVerifier::Report report;
+    QBENCHMARK {
+        report = ArchiveVerifier::verifyArchive(archive, ArchiveConfiguration());
+    }
+    QVERIFY(report.isValid());
+}
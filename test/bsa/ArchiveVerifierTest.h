@@ -0,0 +1,33 @@
+#ifndef BSATOOL_ARCHIVEVERIFIERTEST_H
+#define BSATOOL_ARCHIVEVERIFIERTEST_H
+
+#include <QObject>
+#include <QTemporaryDir>
+
+class ArchiveVerifierTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    /**
+     * @brief create the folder used by the tests
+     */
+    void initTestCase();
+    /**
+     * @brief test the report of the valid and invalid files
+     */
+    void testVerifyArchive();
+    /**
+     * @brief benchmark verifying an archive of many compressed images
+     */
+    void benchmarkVerifyArchive();
+
+private:
+    /**
+     * @brief folder containing the test files
+     */
+    QTemporaryDir mTemporaryDir{};
+};
+
+
+#endif //BSATOOL_ARCHIVEVERIFIERTEST_H
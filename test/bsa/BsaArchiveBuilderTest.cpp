@@ -0,0 +1,187 @@
+#include <QtTest/QtTest>
+#include <bsa/BsaArchiveBuilderTest.h>
+#include <bsa/BsaArchiveBuilder.h>
+#include <bsa/BsaArchive.h>
+#include <bsa/BsaArchiveTest.h>
+#include <assets/Img.h>
+#include <configuration/ArchiveConfiguration.h>
+#include <QtEndian>
+
+void BsaArchiveBuilderTest::initTestCase() {
+    QVERIFY(mTemporaryDir.isValid());
+}
+
+void BsaArchiveBuilderTest::testBuildFromDirectory() {
+    QDir sourceFolder(mTemporaryDir.path());
+    QVERIFY(sourceFolder.mkpath(QStringLiteral("tree/sub")));
+    QVERIFY(sourceFolder.cd(QStringLiteral("tree")));
+    BsaArchiveTest::writeLooseFile(sourceFolder.filePath(QStringLiteral("b.img")), 5000000, 'b');
+    BsaArchiveTest::writeLooseFile(sourceFolder.filePath(QStringLiteral("sub/a.cfa")), 10, 'a');
+    BsaArchiveTest::writeLooseFile(sourceFolder.filePath(QStringLiteral("sub/EMPTY.DAT")), 0, 'e');
+    BsaArchiveBuilder builder;
+    builder.addDirectory(sourceFolder.path());
+    QCOMPARE(builder.filePaths().size(), 3);
+
+    qInfo("Should write all the files in name order");
+    QString archivePath = mTemporaryDir.filePath(QStringLiteral("BUILT.BSA"));
+    QVector<BsaFile> builtFiles = builder.build(archivePath);
+    QCOMPARE(builtFiles.size(), 3);
+    QCOMPARE(builtFiles.at(0).fileName(), QStringLiteral("A.CFA"));
+    QCOMPARE(builtFiles.at(1).startOffsetInArchive(), qint64(12));
+    QCOMPARE(QFileInfo(archivePath).size(), qint64(2 + 5000010 + 3 * BsaArchive::FILETABLE_ENTRY_SIZE));
+
+    qInfo("Should be readable by BsaArchive");
+    BsaArchive archive;
+    archive.openArchive(archivePath);
+    QCOMPARE(archive.fileNumber(), quint16(3));
+    QCOMPARE(archive.getFileData(archive.getFile(QStringLiteral("A.CFA"))) == QVector<char>(10, 'a'), true);
+    QCOMPARE(archive.getFileData(archive.getFile(QStringLiteral("B.IMG"))) == QVector<char>(5000000, 'b'), true);
+    QCOMPARE(archive.getFile(QStringLiteral("EMPTY.DAT")).size(), quint32(0));
+}
+
+void BsaArchiveBuilderTest::testBulkValidation() {
+    QDir sourceFolder(mTemporaryDir.path());
+    QVERIFY(sourceFolder.mkpath(QStringLiteral("invalid/other")));
+    QVERIFY(sourceFolder.cd(QStringLiteral("invalid")));
+    BsaArchiveTest::writeLooseFile(sourceFolder.filePath(QStringLiteral("VERYLONGNAME.DAT")), 1, 'l');
+    BsaArchiveTest::writeLooseFile(sourceFolder.filePath(QStringLiteral("twice.dat")), 1, 't');
+    BsaArchiveTest::writeLooseFile(sourceFolder.filePath(QStringLiteral("other/TWICE.DAT")), 1, 't');
+    BsaArchiveTest::writeLooseFile(sourceFolder.filePath(QStringLiteral("VALID.DAT")), 1, 'v');
+    BsaArchiveBuilder builder;
+    builder.addDirectory(sourceFolder.path());
+    builder.addFile(sourceFolder.filePath(QStringLiteral("MISSING.DAT")));
+
+    qInfo("Should report all the invalid files at once and write nothing");
+    QString archivePath = mTemporaryDir.filePath(QStringLiteral("INVALID.BSA"));
+    try {
+        builder.build(archivePath);
+        QFAIL("The build should fail");
+    } catch (Status &e) {
+        QVERIFY(e.message().contains(QStringLiteral("VERYLONGNAME.DAT")));
+        QVERIFY(e.message().contains(QStringLiteral("TWICE.DAT")));
+        QVERIFY(e.message().contains(QStringLiteral("MISSING.DAT")));
+        QVERIFY(!e.message().contains(QStringLiteral("VALID.DAT :")));
+    }
+    QVERIFY(!QFile::exists(archivePath));
+    QVERIFY(!QFile::exists(archivePath + ".tmp"));
+
+    qInfo("Should refuse a missing directory");
+    QVERIFY_EXCEPTION_THROWN(builder.addDirectory(sourceFolder.filePath(QStringLiteral("missing"))), Status);
+}
+
+void BsaArchiveBuilderTest::testImgRecompression() {
+    QDir sourceFolder(mTemporaryDir.path());
+    QVERIFY(sourceFolder.mkpath(QStringLiteral("img")));
+    QVERIFY(sourceFolder.cd(QStringLiteral("img")));
+    // Uncompressed 64x64 IMG made of horizontal stripes
+    QVector<char> imgData(Img::HEADER_SIZE + 64 * 64, 0);
+    qToLittleEndian(quint16(64), imgData.data() + 4);
+    qToLittleEndian(quint16(64), imgData.data() + 6);
+    qToLittleEndian(quint16(64 * 64), imgData.data() + 10);
+    for (int i(0); i < 64 * 64; i++) {
+        imgData[Img::HEADER_SIZE + i] = char(i / 256);
+    }
+    QFile imgFile(sourceFolder.filePath(QStringLiteral("STRIPES.IMG")));
+    QVERIFY(imgFile.open(QIODevice::WriteOnly));
+    imgFile.write(imgData.constData(), imgData.size());
+    imgFile.close();
+    BsaArchiveTest::writeLooseFile(sourceFolder.filePath(QStringLiteral("BROKEN.IMG")), 5, 'b');
+    BsaArchiveTest::writeLooseFile(sourceFolder.filePath(QStringLiteral("OTHER.DAT")), 1000, 'o');
+    BsaArchiveBuilder builder;
+    builder.addDirectory(sourceFolder.path());
+
+    qInfo("Should store the files as they are by default");
+    QString archivePath = mTemporaryDir.filePath(QStringLiteral("IMG.BSA"));
+    builder.build(archivePath);
+    QVERIFY(builder.imgRecompressionReport().isEmpty());
+    QCOMPARE(QFileInfo(archivePath).size(), qint64(2 + imgData.size() + 5 + 1000 + 3 * 18));
+
+    qInfo("Should store the smallest version of the IMG files and report the saved size");
+    builder.setImgRecompression(true);
+    QVector<BsaFile> builtFiles = builder.build(archivePath);
+    const QVector<BsaArchiveBuilder::ImgRecompression> &report = builder.imgRecompressionReport();
+    QCOMPARE(report.size(), 2);
+    QCOMPARE(report.at(0).fileName, QStringLiteral("BROKEN.IMG"));
+    QCOMPARE(report.at(0).savedSize(), qint64(0));
+    QCOMPARE(report.at(1).fileName, QStringLiteral("STRIPES.IMG"));
+    QVERIFY(report.at(1).savedSize() > 0);
+    QVERIFY(report.at(1).compressionFlag == 0x02 || report.at(1).compressionFlag == 0x04 ||
+            report.at(1).compressionFlag == 0x08);
+    QCOMPARE(QFileInfo(archivePath).size(), qint64(2 + imgData.size() - report.at(1).savedSize() + 5 + 1000 + 3 * 18));
+
+    qInfo("Should rewrite the IMG header to match the new data");
+    BsaArchive archive;
+    archive.openArchive(archivePath);
+    QVector<char> storedData = archive.getFileData(archive.getFile(QStringLiteral("STRIPES.IMG")));
+    QCOMPARE(storedData.size(), imgData.size() - int(report.at(1).savedSize()));
+    QCOMPARE(quint8(storedData.at(8)), report.at(1).compressionFlag);
+    QCOMPARE(qFromLittleEndian<quint16>(storedData.constData() + 10), quint16(storedData.size() - Img::HEADER_SIZE));
+    Img original(imgData);
+    Img recompressed(storedData);
+    QCOMPARE(recompressed.qImage() == original.qImage(), true);
+    QCOMPARE(archive.getFileData(archive.getFile(QStringLiteral("BROKEN.IMG"))) == QVector<char>(5, 'b'), true);
+    QCOMPARE(archive.getFileData(archive.getFile(QStringLiteral("OTHER.DAT"))) == QVector<char>(1000, 'o'), true);
+    QCOMPARE(builtFiles.at(2).startOffsetInArchive(), qint64(2 + 5 + 1000));
+    archive.closeArchive();
+
+    qInfo("Should store as is the IMG files without header");
+    ArchiveConfiguration configuration;
+    FileConfiguration rawConfiguration;
+    rawConfiguration.setFilename(QStringLiteral("STRIPES.IMG"));
+    rawConfiguration.setNoHeader(true);
+    configuration.getFiles().append(rawConfiguration);
+    builder.build(archivePath, configuration);
+    QCOMPARE(builder.imgRecompressionReport().size(), 1);
+    QCOMPARE(builder.imgRecompressionReport().at(0).fileName, QStringLiteral("BROKEN.IMG"));
+    QCOMPARE(QFileInfo(archivePath).size(), qint64(2 + imgData.size() + 5 + 1000 + 3 * 18));
+
+    qInfo("Should only report the compression flag of the files loaded as IMG");
+    const QString garbagePath = mTemporaryDir.filePath(QStringLiteral("GARBAGE.IMG"));
+    BsaArchiveTest::writeLooseFile(garbagePath, 100, 'g');
+    BsaArchiveBuilder garbageBuilder;
+    garbageBuilder.setImgRecompression(true);
+    garbageBuilder.addFile(garbagePath);
+    garbageBuilder.build(mTemporaryDir.filePath(QStringLiteral("GARBAGE.BSA")));
+    QCOMPARE(garbageBuilder.imgRecompressionReport().size(), 1);
+    QCOMPARE(garbageBuilder.imgRecompressionReport().at(0).compressionFlag, quint8(0));
+    QCOMPARE(garbageBuilder.imgRecompressionReport().at(0).savedSize(), qint64(0));
+
+    qInfo("Should store as is an IMG without header whose pixels look like a header, even without configuration");
+    // 16x8 raw pixels starting like the header of an uncompressed 4x4 image
+    QVector<char> rawData(16 * 8, 0);
+    qToLittleEndian(quint16(4), rawData.data() + 4);
+    qToLittleEndian(quint16(4), rawData.data() + 6);
+    qToLittleEndian(quint16(16), rawData.data() + 10);
+    QFile rawFile(mTemporaryDir.filePath(QStringLiteral("RAW.IMG")));
+    QVERIFY(rawFile.open(QIODevice::WriteOnly));
+    rawFile.write(rawData.constData(), rawData.size());
+    rawFile.close();
+    BsaArchiveBuilder rawBuilder;
+    rawBuilder.setImgRecompression(true);
+    rawBuilder.addFile(rawFile.fileName());
+    const QString rawArchivePath = mTemporaryDir.filePath(QStringLiteral("RAW.BSA"));
+    rawBuilder.build(rawArchivePath);
+    QCOMPARE(rawBuilder.imgRecompressionReport().size(), 1);
+    QCOMPARE(rawBuilder.imgRecompressionReport().at(0).compressionFlag, quint8(0));
+    QCOMPARE(rawBuilder.imgRecompressionReport().at(0).savedSize(), qint64(0));
+    BsaArchive rawArchive;
+    rawArchive.openArchive(rawArchivePath);
+    QCOMPARE(rawArchive.getFileData(rawArchive.getFile(QStringLiteral("RAW.IMG"))) == rawData, true);
+}
+
+void BsaArchiveBuilderTest::benchmarkBuildManyFiles() {
+    QDir sourceFolder(mTemporaryDir.path());
+    QVERIFY(sourceFolder.mkpath(QStringLiteral("many")));
+    QVERIFY(sourceFolder.cd(QStringLiteral("many")));
+    for (int i(0); i < 5000; i++) {
+        BsaArchiveTest::writeLooseFile(sourceFolder.filePath(QString("F%1.DAT").arg(i, 5, 10, QChar('0'))),
+                                       1024, char(i));
+    }
+    BsaArchiveBuilder builder;
+    builder.addDirectory(sourceFolder.path());
+    QString archivePath = mTemporaryDir.filePath(QStringLiteral("MANY.BSA"));
+    QBENCHMARK {
+        builder.build(archivePath);
+    }
+    QCOMPARE(QFileInfo(archivePath).size(), qint64(2 + 5000 * (1024 + BsaArchive::FILETABLE_ENTRY_SIZE)));
+}
@@ -0,0 +1,41 @@
+#ifndef BSATOOL_BSAARCHIVEBUILDERTEST_H
+#define BSATOOL_BSAARCHIVEBUILDERTEST_H
+
+#include <QObject>
+#include <QTemporaryDir>
+
+class BsaArchiveBuilderTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    /**
+     * @brief create the folder used by the tests
+     */
+    void initTestCase();
+    /**
+     * @brief test building an archive from a directory tree
+     */
+    void testBuildFromDirectory();
+    /**
+     * @brief test the validation of all the files before writing
+     */
+    void testBulkValidation();
+    /**
+     * @brief test the recompression of the IMG files while building
+     */
+    void testImgRecompression();
+    /**
+     * @brief benchmark building an archive of many small files
+     */
+    void benchmarkBuildManyFiles();
+
+private:
+    /**
+     * @brief folder containing the test files
+     */
+    QTemporaryDir mTemporaryDir{};
+};
+
+
+#endif //BSATOOL_BSAARCHIVEBUILDERTEST_H
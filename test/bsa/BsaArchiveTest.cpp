@@ -0,0 +1,570 @@
+#include <QtTest/QtTest>
+#include <QtConcurrent/QtConcurrent>
+#include <bsa/BsaArchiveTest.h>
+#include <bsa/BsaArchive.h>
+
+void BsaArchiveTest::initTestCase() {
+    qRegisterMetaType<FileListDelta>();
+    qRegisterMetaType<QVector<BsaFile>>("QVector<BsaFile>");
+    QVERIFY(mTemporaryDir.isValid());
+    mReadArchivePath = mTemporaryDir.filePath(QStringLiteral("READ.BSA"));
+    writeSyntheticArchive(mReadArchivePath, 1000, 4096);
+}
+
+void BsaArchiveTest::testMemoryMappedRead() {
+    qInfo("Should give views on the same data than the copies read from the archive");
+    BsaArchive streamArchive;
+    streamArchive.openArchive(mReadArchivePath);
+    BsaArchive mappedArchive;
+    mappedArchive.openArchive(mReadArchivePath, BsaArchive::MEMORY_MAPPED);
+    QVERIFY(!streamArchive.isMemoryMapped());
+    QVERIFY(mappedArchive.isMemoryMapped());
+    QCOMPARE(mappedArchive.fileNumber(), streamArchive.fileNumber());
+    for (const auto &file : streamArchive.getFiles()) {
+        QVector<char> copiedData = streamArchive.getFileData(file);
+        DataView view = mappedArchive.getFileView(file);
+        QCOMPARE(view.size(), qint64(copiedData.size()));
+        QVERIFY(equal(view.begin(), view.end(), copiedData.begin()));
+        QCOMPARE(mappedArchive.getFileData(file) == copiedData, true);
+    }
+
+    qInfo("Should refuse to give a view when the archive is not memory mapped");
+    QVERIFY_EXCEPTION_THROWN(streamArchive.getFileView(streamArchive.getFiles().first()), Status);
+}
+
+void BsaArchiveTest::testConcurrentRead() {
+    const int threadNumber = 16;
+    for (const auto openFlags : {BsaArchive::OpenFlags(BsaArchive::NO_OPEN_FLAG),
+                                 BsaArchive::OpenFlags(BsaArchive::MEMORY_MAPPED)}) {
+        BsaArchive archive;
+        archive.openArchive(mReadArchivePath, openFlags);
+        const QVector<BsaFile> files = archive.getFiles();
+        QVector<QVector<char>> serialData;
+        for (const auto &file : files) {
+            serialData.append(archive.getFileData(file));
+        }
+
+        qInfo("Should read from many threads the same data than serial reads");
+        QThreadPool threadPool;
+        threadPool.setMaxThreadCount(threadNumber);
+        QVector<QFuture<int>> futures;
+        for (int thread(0); thread < threadNumber; thread++) {
+            futures.append(QtConcurrent::run(&threadPool, [&archive, &files, &serialData, thread]() {
+                int mismatches(0);
+                // each thread starts at a different file to mix the offsets read at the same time
+                for (int i(0); i < files.size(); i++) {
+                    int idx = (i + thread * 61) % files.size();
+                    if (archive.getFileData(files.at(idx)) != serialData.at(idx)) {
+                        mismatches++;
+                    }
+                }
+                return mismatches;
+            }));
+        }
+        for (auto &future : futures) {
+            QCOMPARE(future.result(), 0);
+        }
+
+        qInfo("Should read all the files concurrently in the given order");
+        QCOMPARE(archive.getFilesData(files) == serialData, true);
+    }
+}
+
+void BsaArchiveTest::testExtractFiles() {
+    BsaArchive archive;
+    archive.openArchive(mReadArchivePath, BsaArchive::MEMORY_MAPPED);
+    QVector<BsaFile> files = archive.getFiles();
+    QDir destination(mTemporaryDir.path());
+    QVERIFY(destination.mkpath(QStringLiteral("extracted")));
+    QVERIFY(destination.cd(QStringLiteral("extracted")));
+
+    qInfo("Should extract every file and report the progress");
+    QSignalSpy progressSpy(&archive, &BsaArchive::extractionProgress);
+    QVector<Status> results = archive.extractAll(destination.path());
+    QCOMPARE(results.size(), files.size());
+    QCOMPARE(progressSpy.count(), files.size());
+    QCOMPARE(progressSpy.last().at(0).toInt(), files.size());
+    for (int i(0); i < files.size(); i++) {
+        QCOMPARE(results.at(i).code(), 0);
+        QFile extractedFile(destination.filePath(files.at(i).fileName()));
+        QVERIFY(extractedFile.open(QIODevice::ReadOnly));
+        QByteArray extractedData = extractedFile.readAll();
+        QCOMPARE(QVector<char>(extractedData.begin(), extractedData.end()) == archive.getFileData(files.at(i)), true);
+    }
+
+    qInfo("Should report a failing file without stopping the others");
+    QVector<BsaFile> someFiles{files.at(0), BsaFile(10, 2, QStringLiteral("MISSING.DAT")), files.at(1)};
+    results = archive.extractFiles(destination.path(), someFiles);
+    QCOMPARE(results.size(), 3);
+    QCOMPARE(results.at(0).code(), 0);
+    QCOMPARE(results.at(1).code(), -1);
+    QCOMPARE(results.at(2).code(), 0);
+    QVERIFY(!destination.exists(QStringLiteral("MISSING.DAT")));
+}
+
+void BsaArchiveTest::testGetFileByName() {
+    BsaArchive archive;
+    qInfo("Should not find any file in a closed archive");
+    QVERIFY(!archive.getFile(QStringLiteral("F00010.DAT")).isValid());
+
+    archive.openArchive(mReadArchivePath);
+    qInfo("Should find every file of the archive from its name");
+    for (const auto &file : archive.getFiles()) {
+        BsaFile foundFile = archive.getFile(file.fileName());
+        QVERIFY(foundFile.isValid());
+        QCOMPARE(foundFile.fileName(), file.fileName());
+        QCOMPARE(foundFile.startOffsetInArchive(), file.startOffsetInArchive());
+    }
+
+    qInfo("Should not find a file missing from the archive");
+    QVERIFY(!archive.getFile(QStringLiteral("MISSING.DAT")).isValid());
+    QVERIFY(!archive.getFile(QStringLiteral("F00010.DA")).isValid());
+}
+
+void BsaArchiveTest::testAddOrUpdateFiles() {
+    QDir looseFolder(mTemporaryDir.path());
+    QVERIFY(looseFolder.mkpath(QStringLiteral("loose")));
+    QVERIFY(looseFolder.cd(QStringLiteral("loose")));
+    writeLooseFile(looseFolder.filePath(QStringLiteral("a.dat")), 10, 'a');
+    writeLooseFile(looseFolder.filePath(QStringLiteral("f00003.dat")), 20, 'f');
+    writeLooseFile(looseFolder.filePath(QStringLiteral("z.dat")), 30, 'z');
+    BsaArchive archive;
+    archive.openArchive(mReadArchivePath);
+
+    qInfo("Should insert a new file at its sorted place");
+    archive.addOrUpdateFile(looseFolder.filePath(QStringLiteral("z.dat")));
+    const QVector<BsaFile> filesAfterSingleAdd = archive.getFiles();
+    QCOMPARE(filesAfterSingleAdd.last().fileName(), QStringLiteral("Z.DAT"));
+    QVERIFY(is_sorted(filesAfterSingleAdd.begin(), filesAfterSingleAdd.end()));
+
+    qInfo("Should add and update files in one batch with a single notification");
+    QSignalSpy updateSpy(&archive, &BsaArchive::fileListChanged);
+    QSignalSpy listSpy(&archive, &BsaArchive::fileListModified);
+    QSignalSpy modifiedSpy(&archive, &BsaArchive::fileModified);
+    QVector<BsaFile> updatedFiles = archive.addOrUpdateFiles({looseFolder.filePath(QStringLiteral("z.dat")),
+                                                              looseFolder.filePath(QStringLiteral("f00003.dat")),
+                                                              looseFolder.filePath(QStringLiteral("a.dat"))});
+    QCOMPARE(updateSpy.count(), 1);
+    QCOMPARE(listSpy.count(), 1);
+    QCOMPARE(modifiedSpy.count(), 2);
+    QCOMPARE(archive.fileNumber(), quint16(1002));
+    const QVector<BsaFile> files = archive.getFiles();
+    QVERIFY(is_sorted(files.begin(), files.end()));
+    QCOMPARE(updatedFiles.size(), 3);
+    auto delta = updateSpy.first().at(0).value<FileListDelta>();
+    QCOMPARE(delta.insertedIndexes, QVector<int>({0}));
+    QCOMPARE(delta.modifiedIndexes, QVector<int>({4, 1001}));
+    QVERIFY(delta.removedIndexes.isEmpty());
+    QCOMPARE(files.at(0).fileName(), QStringLiteral("A.DAT"));
+    QVERIFY(files.at(0).isNew());
+    QCOMPARE(files.at(4).fileName(), QStringLiteral("F00003.DAT"));
+    QVERIFY(files.at(4).updated());
+    QCOMPARE(files.at(4).updateFileSize(), quint32(20));
+    QCOMPARE(files.at(1001).fileName(), QStringLiteral("Z.DAT"));
+    QVERIFY(files.at(1001).isNew());
+    QCOMPARE(archive.getModifiedFilePath(files.at(4)), looseFolder.filePath(QStringLiteral("f00003.dat")));
+    QCOMPARE(archive.getModifiedFilePath(files.at(5)), QString());
+
+    qInfo("Should not change anything if one of the files is invalid");
+    QVERIFY_EXCEPTION_THROWN(archive.addOrUpdateFiles({looseFolder.filePath(QStringLiteral("a.dat")),
+                                                       looseFolder.filePath(QStringLiteral("missing.dat"))}), Status);
+    QCOMPARE(archive.fileNumber(), quint16(1002));
+    QCOMPARE(updateSpy.count(), 1);
+    QCOMPARE(listSpy.count(), 1);
+}
+
+void BsaArchiveTest::testFileListDelta() {
+    QDir looseFolder(mTemporaryDir.path());
+    QVERIFY(looseFolder.mkpath(QStringLiteral("delta")));
+    QVERIFY(looseFolder.cd(QStringLiteral("delta")));
+    writeLooseFile(looseFolder.filePath(QStringLiteral("b.dat")), 10, 'b');
+    writeLooseFile(looseFolder.filePath(QStringLiteral("f00010.dat")), 20, 'f');
+    BsaArchive archive;
+    archive.openArchive(mReadArchivePath);
+    const QVector<BsaFile> &files = archive.files();
+    QSignalSpy deltaSpy(&archive, &BsaArchive::fileListChanged);
+
+    qInfo("Should describe a single insertion, update and deletion");
+    archive.addOrUpdateFile(looseFolder.filePath(QStringLiteral("b.dat")));
+    QCOMPARE(deltaSpy.last().at(0).value<FileListDelta>().insertedIndexes, QVector<int>({0}));
+    archive.addOrUpdateFile(looseFolder.filePath(QStringLiteral("f00010.dat")));
+    QCOMPARE(deltaSpy.last().at(0).value<FileListDelta>().modifiedIndexes, QVector<int>({11}));
+    archive.deleteFile(archive.getFile(QStringLiteral("F00500.DAT")));
+    QCOMPARE(deltaSpy.last().at(0).value<FileListDelta>().removedIndexes, QVector<int>({501}));
+    QCOMPARE(deltaSpy.count(), 3);
+
+    qInfo("Should keep the total size up to date");
+    QCOMPARE(archive.size(), qint64(999) * 4096 + 10 + 20 - 4096);
+    archive.revertChanges(archive.getFile(QStringLiteral("B.DAT")));
+    QCOMPARE(archive.size(), qint64(998) * 4096 + 20);
+    archive.revertChanges(archive.getFile(QStringLiteral("F00010.DAT")));
+    QCOMPARE(archive.size(), qint64(999) * 4096);
+    QVERIFY(!archive.getFile(QStringLiteral("F00010.DAT")).updated());
+
+    qInfo("Should give access to the files without copy");
+    QVERIFY(&files == &archive.files());
+    QCOMPARE(files.size(), 999);
+    QCOMPARE(files.first().fileName(), QStringLiteral("F00000.DAT"));
+}
+
+void BsaArchiveTest::testCompactBsaFile() {
+    qInfo("Should keep files small and trivially copyable");
+    QVERIFY(sizeof(BsaFile) <= 32);
+    QVERIFY(std::is_trivially_copyable<BsaFile>::value);
+
+    qInfo("Should keep the name and compare files by name");
+    BsaFile file(10, 2, QStringLiteral("ABCDEFGHI.IMG"));
+    QCOMPARE(file.fileName(), QStringLiteral("ABCDEFGHI.IMG"));
+    QCOMPARE(file.getExtension(), QStringLiteral("IMG"));
+    QCOMPARE(qstrlen(file.rawFileName()), uint(13));
+    QVERIFY(BsaFile(1, 2, "A.DAT") < BsaFile(1, 2, "AB.DAT"));
+    QVERIFY(BsaFile(1, 2, "B.DAT") > BsaFile(1, 2, "AB.DAT"));
+    QVERIFY(BsaFile(1, 2, "A.DAT") == BsaFile(5, 10, QStringLiteral("A.DAT")));
+    QVERIFY(!BsaFile().isValid());
+
+    qInfo("Should keep the flags independent");
+    file.setIsNew(true);
+    file.setUpdated(true);
+    file.setIsNew(false);
+    QVERIFY(!file.isNew());
+    QVERIFY(file.updated());
+
+    qInfo("Should refuse too long names");
+    QVERIFY_EXCEPTION_THROWN(BsaFile(1, 2, QStringLiteral("ABCDEFGHIJ.IMG")), Status);
+}
+
+void BsaArchiveTest::testSaveArchive() {
+    QDir looseFolder(mTemporaryDir.path());
+    QVERIFY(looseFolder.mkpath(QStringLiteral("save")));
+    QVERIFY(looseFolder.cd(QStringLiteral("save")));
+    writeLooseFile(looseFolder.filePath(QStringLiteral("F00500.DAT")), 100000, 'u');
+    writeLooseFile(looseFolder.filePath(QStringLiteral("NEW.DAT")), 3, 'n');
+    for (const auto openFlags : {BsaArchive::OpenFlags(BsaArchive::NO_OPEN_FLAG),
+                                 BsaArchive::OpenFlags(BsaArchive::MEMORY_MAPPED)}) {
+        BsaArchive archive;
+        archive.openArchive(mReadArchivePath, openFlags);
+        const QVector<BsaFile> originalFiles = archive.getFiles();
+        const QVector<QVector<char>> originalData = archive.getFilesData(originalFiles);
+        archive.addOrUpdateFiles({looseFolder.filePath(QStringLiteral("F00500.DAT")),
+                                  looseFolder.filePath(QStringLiteral("NEW.DAT"))});
+
+        qInfo("Should save the updated and new files along with the unchanged ones");
+        QString savePath = looseFolder.filePath(QStringLiteral("SAVED.BSA"));
+        QSignalSpy listSpy(&archive, &BsaArchive::fileListModified);
+        QSignalSpy closedSpy(&archive, &BsaArchive::archiveClosed);
+        archive.saveArchive(savePath);
+        QVERIFY(!archive.isModified());
+        QCOMPARE(archive.isMemoryMapped(), openFlags.testFlag(BsaArchive::MEMORY_MAPPED));
+
+        qInfo("Should keep working on the saved archive without reopening it");
+        QCOMPARE(listSpy.count(), 1);
+        QCOMPARE(closedSpy.count(), 0);
+        QCOMPARE(archive.getFileData(archive.getFile(QStringLiteral("F00500.DAT"))) ==
+                 QVector<char>(100000, 'u'), true);
+        QCOMPARE(archive.getFileData(archive.getFile(QStringLiteral("F00999.DAT"))) ==
+                 originalData.last(), true);
+        BsaArchive savedArchive;
+        savedArchive.openArchive(savePath);
+        QCOMPARE(savedArchive.fileNumber(), quint16(originalFiles.size() + 1));
+        QCOMPARE(savedArchive.getFileData(savedArchive.getFile(QStringLiteral("F00500.DAT"))) ==
+                 QVector<char>(100000, 'u'), true);
+        QCOMPARE(savedArchive.getFileData(savedArchive.getFile(QStringLiteral("NEW.DAT"))) ==
+                 QVector<char>(3, 'n'), true);
+        for (int i(0); i < originalFiles.size(); i++) {
+            if (originalFiles.at(i).fileName() != QStringLiteral("F00500.DAT")) {
+                QCOMPARE(savedArchive.getFileData(originalFiles.at(i)) == originalData.at(i), true);
+            }
+        }
+    }
+}
+
+void BsaArchiveTest::testSaveArchiveIncrementally() {
+    QDir looseFolder(mTemporaryDir.path());
+    QVERIFY(looseFolder.mkpath(QStringLiteral("incremental")));
+    QVERIFY(looseFolder.cd(QStringLiteral("incremental")));
+    writeLooseFile(looseFolder.filePath(QStringLiteral("F00990.DAT")), 50000, 'u');
+    writeLooseFile(looseFolder.filePath(QStringLiteral("A.DAT")), 7, 'a');
+    for (const auto openFlags : {BsaArchive::OpenFlags(BsaArchive::NO_OPEN_FLAG),
+                                 BsaArchive::OpenFlags(BsaArchive::MEMORY_MAPPED)}) {
+        QString archivePath = looseFolder.filePath(QStringLiteral("INPLACE.BSA"));
+        QFile::remove(archivePath);
+        QVERIFY(QFile::copy(mReadArchivePath, archivePath));
+        BsaArchive archive;
+        archive.openArchive(archivePath, openFlags);
+        const QVector<BsaFile> originalFiles = archive.getFiles();
+        const QVector<QVector<char>> originalData = archive.getFilesData(originalFiles);
+        archive.addOrUpdateFiles({looseFolder.filePath(QStringLiteral("F00990.DAT")),
+                                  looseFolder.filePath(QStringLiteral("A.DAT"))});
+        archive.deleteFile(archive.getFile(QStringLiteral("F00995.DAT")));
+
+        qInfo("Should save the archive in place and keep the files list usable");
+        archive.saveArchiveIncrementally();
+        QVERIFY(!archive.isModified());
+        QVERIFY(!QFile::exists(archivePath + BsaArchive::JOURNAL_EXT));
+        QCOMPARE(archive.isMemoryMapped(), openFlags.testFlag(BsaArchive::MEMORY_MAPPED));
+        QCOMPARE(archive.getFileData(archive.getFile(QStringLiteral("F00990.DAT"))) ==
+                 QVector<char>(50000, 'u'), true);
+
+        qInfo("Should read the saved archive as a whole new archive");
+        BsaArchive savedArchive;
+        savedArchive.openArchive(archivePath);
+        QCOMPARE(savedArchive.fileNumber(), quint16(originalFiles.size()));
+        QCOMPARE(savedArchive.size(), QFileInfo(archivePath).size() - 2 -
+                                      BsaArchive::FILETABLE_ENTRY_SIZE * savedArchive.fileNumber());
+        QCOMPARE(savedArchive.getFile(QStringLiteral("F00995.DAT")) == BsaFile::INVALID_BSAFILE, true);
+        QCOMPARE(savedArchive.getFileData(savedArchive.getFile(QStringLiteral("A.DAT"))) ==
+                 QVector<char>(7, 'a'), true);
+        QCOMPARE(savedArchive.getFileData(savedArchive.getFile(QStringLiteral("F00990.DAT"))) ==
+                 QVector<char>(50000, 'u'), true);
+        for (int i(0); i < originalFiles.size(); i++) {
+            const QString &fileName = originalFiles.at(i).fileName();
+            if (fileName != QStringLiteral("F00990.DAT") && fileName != QStringLiteral("F00995.DAT")) {
+                QCOMPARE(savedArchive.getFileData(savedArchive.getFile(fileName)) == originalData.at(i), true);
+            }
+        }
+    }
+
+    qInfo("Should finish an interrupted in place save when opening the archive");
+    QString archivePath = looseFolder.filePath(QStringLiteral("JOURNAL.BSA"));
+    writeSyntheticArchive(archivePath, 3, 4);
+    {
+        QFile journal(archivePath + BsaArchive::JOURNAL_EXT);
+        QVERIFY(journal.open(QIODevice::WriteOnly));
+        QDataStream journalStream(&journal);
+        journalStream.setByteOrder(QDataStream::LittleEndian);
+        // Keeping the first file, replacing the two others by a single 2 bytes file
+        journalStream << quint64(2 + 4) << quint16(2) << quint64(2 + 2 * BsaArchive::FILETABLE_ENTRY_SIZE);
+        journalStream.writeRawData("zz", 2);
+        QByteArray fileTable(2 * BsaArchive::FILETABLE_ENTRY_SIZE, '\0');
+        memcpy(fileTable.data(), "F00000.DAT", 10);
+        fileTable[14] = 4;
+        memcpy(fileTable.data() + BsaArchive::FILETABLE_ENTRY_SIZE, "Z.DAT", 5);
+        fileTable[BsaArchive::FILETABLE_ENTRY_SIZE + 14] = 2;
+        journal.write(fileTable);
+    }
+    BsaArchive archive;
+    archive.openArchive(archivePath);
+    QVERIFY(!QFile::exists(archivePath + BsaArchive::JOURNAL_EXT));
+    QCOMPARE(archive.fileNumber(), quint16(2));
+    QCOMPARE(archive.getFileData(archive.getFile(QStringLiteral("Z.DAT"))) == QVector<char>(2, 'z'), true);
+    QCOMPARE(archive.getFileData(archive.getFile(QStringLiteral("F00000.DAT"))).size(), 4);
+    archive.closeArchive();
+
+    qInfo("Should ignore an incomplete journal");
+    writeSyntheticArchive(archivePath, 3, 4);
+    {
+        QFile journal(archivePath + BsaArchive::JOURNAL_EXT);
+        QVERIFY(journal.open(QIODevice::WriteOnly));
+        QDataStream journalStream(&journal);
+        journalStream.setByteOrder(QDataStream::LittleEndian);
+        journalStream << quint64(2) << quint16(0) << quint64(-1);
+    }
+    archive.openArchive(archivePath);
+    QVERIFY(!QFile::exists(archivePath + BsaArchive::JOURNAL_EXT));
+    QCOMPARE(archive.fileNumber(), quint16(3));
+}
+
+void BsaArchiveTest::testOpenCorruptedArchive() {
+    QDir corruptedFolder(mTemporaryDir.path());
+    QVERIFY(corruptedFolder.mkpath(QStringLiteral("corrupted")));
+    QVERIFY(corruptedFolder.cd(QStringLiteral("corrupted")));
+    QString archivePath = corruptedFolder.filePath(QStringLiteral("CORRUPT.BSA"));
+    for (const auto openFlags : {BsaArchive::OpenFlags(BsaArchive::NO_OPEN_FLAG),
+                                 BsaArchive::OpenFlags(BsaArchive::MEMORY_MAPPED)}) {
+        BsaArchive archive;
+        qInfo("Should refuse an archive whose file sizes do not match its size");
+        writeSyntheticArchive(archivePath, 10, 8);
+        {
+            QFile file(archivePath);
+            QVERIFY(file.open(QIODevice::ReadWrite));
+            QVERIFY(file.seek(file.size() - 4));
+            QDataStream stream(&file);
+            stream.setByteOrder(QDataStream::LittleEndian);
+            stream << quint32(9);
+        }
+        QVERIFY_EXCEPTION_THROWN(archive.openArchive(archivePath, openFlags), Status);
+        QVERIFY(!archive.isOpened());
+        QCOMPARE(archive.getFiles().isEmpty(), true);
+
+        qInfo("Should refuse an archive whose file table is larger than the archive");
+        {
+            QFile file(archivePath);
+            QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+            QDataStream stream(&file);
+            stream.setByteOrder(QDataStream::LittleEndian);
+            stream << quint16(500);
+        }
+        QVERIFY_EXCEPTION_THROWN(archive.openArchive(archivePath, openFlags), Status);
+        QVERIFY(!archive.isOpened());
+
+        qInfo("Should open a valid archive after a failed opening");
+        archive.openArchive(mReadArchivePath, openFlags);
+        QCOMPARE(archive.fileNumber(), quint16(1000));
+        QCOMPARE(archive.getFile(QStringLiteral("F00999.DAT")).size(), quint32(4096));
+    }
+}
+
+void BsaArchiveTest::testLazyOpen() {
+    BsaArchive fullArchive;
+    fullArchive.openArchive(mReadArchivePath);
+    const QVector<BsaFile> fullFiles = fullArchive.getFiles();
+    for (const auto openFlags : {BsaArchive::OpenFlags(BsaArchive::LAZY_FILE_TABLE),
+                                 BsaArchive::LAZY_FILE_TABLE | BsaArchive::MEMORY_MAPPED}) {
+        BsaArchive archive;
+        QSignalSpy listSpy(&archive, &BsaArchive::fileListModified);
+        archive.openArchive(mReadArchivePath, openFlags);
+
+        qInfo("Should give the archive infos without building the files list");
+        QCOMPARE(listSpy.count(), 0);
+        QCOMPARE(archive.fileNumber(), fullArchive.fileNumber());
+        QCOMPARE(archive.size(), fullArchive.size());
+        QVERIFY(!archive.isModified());
+
+        qInfo("Should find and read files by name from the raw file table");
+        BsaFile file = archive.getFile(QStringLiteral("F00500.DAT"));
+        BsaFile fullFile = fullArchive.getFile(QStringLiteral("F00500.DAT"));
+        QCOMPARE(file.startOffsetInArchive(), fullFile.startOffsetInArchive());
+        QCOMPARE(file.size(), fullFile.size());
+        QCOMPARE(archive.getFileData(file) == fullArchive.getFileData(fullFile), true);
+        QCOMPARE(archive.getFile(QStringLiteral("F00000.DAT")).startOffsetInArchive(), qint64(2));
+        QCOMPARE(archive.getFile(QStringLiteral("F0050.DAT")) == BsaFile::INVALID_BSAFILE, true);
+        QCOMPARE(archive.getFile(QStringLiteral("F00500.DATA")) == BsaFile::INVALID_BSAFILE, true);
+        QVERIFY_EXCEPTION_THROWN(archive.getFileData(BsaFile(1, 2, QStringLiteral("MISSING.DAT"))), Status);
+
+        qInfo("Should build the same files list on first enumeration");
+        const QVector<BsaFile> files = archive.getFiles();
+        QCOMPARE(files.size(), fullFiles.size());
+        for (int i(0); i < files.size(); i++) {
+            QCOMPARE(files.at(i).fileName(), fullFiles.at(i).fileName());
+            QCOMPARE(files.at(i).startOffsetInArchive(), fullFiles.at(i).startOffsetInArchive());
+        }
+        QCOMPARE(archive.getFileData(archive.getFile(QStringLiteral("F00999.DAT"))) ==
+                 fullArchive.getFileData(fullArchive.getFile(QStringLiteral("F00999.DAT"))), true);
+        archive.closeArchive();
+        QCOMPARE(archive.getFile(QStringLiteral("F00500.DAT")) == BsaFile::INVALID_BSAFILE, true);
+    }
+}
+
+void BsaArchiveTest::benchmarkFullArchiveReadCopy() {
+    BsaArchive archive;
+    archive.openArchive(mReadArchivePath);
+    const QVector<BsaFile> files = archive.getFiles();
+    qint64 checksum(0);
+    QBENCHMARK {
+        for (const auto &file : files) {
+            checksum += archive.getFileData(file).last();
+        }
+    }
+    QVERIFY(checksum != 0);
+}
+
+void BsaArchiveTest::benchmarkFullArchiveReadMapped() {
+    BsaArchive archive;
+    archive.openArchive(mReadArchivePath, BsaArchive::MEMORY_MAPPED);
+    const QVector<BsaFile> files = archive.getFiles();
+    qint64 checksum(0);
+    QBENCHMARK {
+        for (const auto &file : files) {
+            DataView view = archive.getFileView(file);
+            checksum += view.data()[view.size() - 1];
+        }
+    }
+    QVERIFY(checksum != 0);
+}
+
+void BsaArchiveTest::benchmarkSaveWithFewUpdatedFiles() {
+    QDir benchmarkFolder(mTemporaryDir.path());
+    QVERIFY(benchmarkFolder.mkpath(QStringLiteral("saveBenchmark")));
+    QVERIFY(benchmarkFolder.cd(QStringLiteral("saveBenchmark")));
+    QString archivePath = benchmarkFolder.filePath(QStringLiteral("LARGE.BSA"));
+    writeSyntheticArchive(archivePath, 2000, 32768);
+    QStringList updatedFilePaths;
+    for (int i(0); i < 2000; i += 100) {
+        updatedFilePaths.append(benchmarkFolder.filePath(QString("F%1.DAT").arg(i, 5, 10, QChar('0'))));
+        writeLooseFile(updatedFilePaths.last(), 32768, 'u');
+    }
+    BsaArchive archive;
+    archive.openArchive(archivePath, BsaArchive::MEMORY_MAPPED);
+    QBENCHMARK {
+        archive.addOrUpdateFiles(updatedFilePaths);
+        archive.saveArchive(archivePath);
+    }
+    QCOMPARE(archive.fileNumber(), quint16(2000));
+}
+
+void BsaArchiveTest::benchmarkOpenLargeFileTable() {
+    QString archivePath = mTemporaryDir.filePath(QStringLiteral("MAXFILES.BSA"));
+    writeSyntheticArchive(archivePath, 65535, 1);
+    BsaArchive archive;
+    QBENCHMARK {
+        archive.openArchive(archivePath);
+        archive.closeArchive();
+    }
+    archive.openArchive(archivePath);
+    QCOMPARE(archive.fileNumber(), quint16(65535));
+}
+
+void BsaArchiveTest::benchmarkFirstReadLargeFileTable_data() {
+    QTest::addColumn<bool>("lazy");
+    QTest::newRow("full") << false;
+    QTest::newRow("lazy") << true;
+}
+
+void BsaArchiveTest::benchmarkFirstReadLargeFileTable() {
+    QFETCH(bool, lazy);
+    QString archivePath = mTemporaryDir.filePath(QStringLiteral("MAXFILES.BSA"));
+    if (!QFile::exists(archivePath)) {
+        writeSyntheticArchive(archivePath, 65535, 1);
+    }
+    BsaArchive::OpenFlags openFlags = lazy ? BsaArchive::LAZY_FILE_TABLE : BsaArchive::NO_OPEN_FLAG;
+    BsaArchive archive;
+    QBENCHMARK {
+        archive.openArchive(archivePath, openFlags);
+        QCOMPARE(archive.getFileData(archive.getFile(QStringLiteral("F40000.DAT"))).size(), 1);
+        archive.closeArchive();
+    }
+}
+
+void BsaArchiveTest::benchmarkSize() {
+    QString archivePath = mTemporaryDir.filePath(QStringLiteral("MAXFILES.BSA"));
+    if (!QFile::exists(archivePath)) {
+        writeSyntheticArchive(archivePath, 65535, 1);
+    }
+    BsaArchive archive;
+    archive.openArchive(archivePath);
+    qint64 totalSize(0);
+    QBENCHMARK {
+        totalSize += archive.size();
+    }
+    QVERIFY(totalSize >= 65535);
+}
+
+void BsaArchiveTest::writeSyntheticArchive(const QString &filePath, quint16 fileNumber, quint32 fileSize) {
+    QFile file(filePath);
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    QDataStream stream(&file);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    stream << fileNumber;
+    QVector<char> data(int(fileSize));
+    for (quint16 i(0); i < fileNumber; i++) {
+        for (quint32 j(0); j < fileSize; j++) {
+            data[int(j)] = char((i * 31u + j) & 0xFFu);
+        }
+        stream.writeRawData(data.constData(), data.size());
+    }
+    for (quint16 i(0); i < fileNumber; i++) {
+        char name[14] = {0};
+        QByteArray fileName = QString("F%1.DAT").arg(i, 5, 10, QChar('0')).toLatin1();
+        memcpy(&name[0], fileName.constData(), size_t(fileName.size()));
+        stream.writeRawData(&name[0], 14);
+        stream << fileSize;
+    }
+    file.close();
+}
+
+void BsaArchiveTest::writeLooseFile(const QString &filePath, int size, char byte) {
+    QFile file(filePath);
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    file.write(QByteArray(size, byte));
+    file.close();
+}
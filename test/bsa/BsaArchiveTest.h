@@ -0,0 +1,116 @@
+#ifndef BSATOOL_BSAARCHIVETEST_H
+#define BSATOOL_BSAARCHIVETEST_H
+
+#include <QObject>
+#include <QTemporaryDir>
+
+class BsaArchiveTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    /**
+     * @brief create the synthetic archives used by the tests
+     */
+    void initTestCase();
+    /**
+     * @brief test memory mapped reading
+     */
+    void testMemoryMappedRead();
+    /**
+     * @brief test reading one archive from many threads
+     */
+    void testConcurrentRead();
+    /**
+     * @brief test bulk extraction
+     */
+    void testExtractFiles();
+    /**
+     * @brief test file lookup by name
+     */
+    void testGetFileByName();
+    /**
+     * @brief test adding or updating files one by one and in batch
+     */
+    void testAddOrUpdateFiles();
+    /**
+     * @brief test the change descriptions sent when files are added, updated or deleted
+     */
+    void testFileListDelta();
+    /**
+     * @brief test the compact file representation
+     */
+    void testCompactBsaFile();
+    /**
+     * @brief test saving an archive with new and updated files
+     */
+    void testSaveArchive();
+    /**
+     * @brief test saving an archive in place, and finishing an interrupted in place save
+     */
+    void testSaveArchiveIncrementally();
+    /**
+     * @brief test opening corrupted archives
+     */
+    void testOpenCorruptedArchive();
+    /**
+     * @brief test opening an archive without building its files list
+     */
+    void testLazyOpen();
+    /**
+     * @brief benchmark full archive reading through copies
+     */
+    void benchmarkFullArchiveReadCopy();
+    /**
+     * @brief benchmark full archive reading through memory mapped views
+     */
+    void benchmarkFullArchiveReadMapped();
+    /**
+     * @brief benchmark saving a large archive with 1% of its files updated
+     */
+    void benchmarkSaveWithFewUpdatedFiles();
+    /**
+     * @brief benchmark opening an archive with the maximum number of files
+     */
+    void benchmarkOpenLargeFileTable();
+    /**
+     * @brief benchmark opening an archive with the maximum number of files and reading a single file, with and
+     * without building the files list
+     */
+    void benchmarkFirstReadLargeFileTable_data();
+    void benchmarkFirstReadLargeFileTable();
+    /**
+     * @brief benchmark getting the data size of an archive with the maximum number of files
+     */
+    void benchmarkSize();
+
+public:
+    /**
+     * Write an archive whose files contain a deterministic byte pattern
+     * @param filePath path of the archive to write
+     * @param fileNumber number of files in the archive
+     * @param fileSize size of each file
+     */
+    static void writeSyntheticArchive(const QString &filePath, quint16 fileNumber, quint32 fileSize);
+
+    /**
+     * Write a loose file filled with the given byte
+     * @param filePath path of the file to write
+     * @param size size of the file
+     * @param byte value of every byte of the file
+     */
+    static void writeLooseFile(const QString &filePath, int size, char byte);
+
+private:
+    /**
+     * @brief folder containing the test archives
+     */
+    QTemporaryDir mTemporaryDir{};
+    /**
+     * @brief path to the archive used by the read tests
+     */
+    QString mReadArchivePath{};
+};
+
+
+#endif //BSATOOL_BSAARCHIVETEST_H
@@ -0,0 +1,119 @@
+#include <QtTest/QtTest>
+#include <bsa/DecodeCacheTest.h>
+#include <bsa/DecodeCache.h>
+#include <bsa/BsaArchiveBuilder.h>
+#include <QtEndian>
+
+void DecodeCacheTest::writeStripesImg(const QString &filePath, quint16 width, quint16 height, char firstColor) {
+    QVector<char> imgData(Img::HEADER_SIZE + width * height, 0);
+    qToLittleEndian(width, imgData.data() + 4);
+    qToLittleEndian(height, imgData.data() + 6);
+    qToLittleEndian(quint16(width * height), imgData.data() + 10);
+    for (int i(0); i < width * height; i++) {
+        imgData[Img::HEADER_SIZE + i] = char(firstColor + i / width);
+    }
+    QFile imgFile(filePath);
+    QVERIFY(imgFile.open(QIODevice::WriteOnly));
+    QCOMPARE(imgFile.write(imgData.constData(), imgData.size()), qint64(imgData.size()));
+}
+
+void DecodeCacheTest::initTestCase() {
+    QVERIFY(mTemporaryDir.isValid());
+    QDir sourceFolder(mTemporaryDir.path());
+    QVERIFY(sourceFolder.mkpath(QStringLiteral("images")));
+    QVERIFY(sourceFolder.cd(QStringLiteral("images")));
+    writeStripesImg(sourceFolder.filePath(QStringLiteral("A.IMG")), 32, 16, 0);
+    writeStripesImg(sourceFolder.filePath(QStringLiteral("B.IMG")), 32, 16, 100);
+    BsaArchiveBuilder builder;
+    builder.addDirectory(sourceFolder.path());
+    mArchivePath = mTemporaryDir.filePath(QStringLiteral("IMAGES.BSA"));
+    builder.build(mArchivePath);
+}
+
+void DecodeCacheTest::testHitsAndMisses() {
+    BsaArchive archive;
+    archive.openArchive(mArchivePath);
+    DecodeCache cache(archive);
+    BsaFile file = archive.getFile(QStringLiteral("A.IMG"));
+
+    qInfo("Should decode the file on first request");
+    Img decoded = cache.getImg(file);
+    QCOMPARE(cache.missNumber(), qint64(1));
+    QCOMPARE(cache.hitNumber(), qint64(0));
+    QCOMPARE(cache.usedBytes(), 32 * 16);
+
+    qInfo("Should answer the next requests from the cache");
+    Img cached = cache.getImg(file);
+    QCOMPARE(cache.missNumber(), qint64(1));
+    QCOMPARE(cache.hitNumber(), qint64(1));
+    QCOMPARE(cached.qImage() == decoded.qImage(), true);
+    QCOMPARE(cached.qImage() == Img(archive.getFileData(file)).qImage(), true);
+
+    qInfo("Should decode again with another palette");
+    Palette otherPalette(QVector<char>(768, 1));
+    Img otherCached = cache.getImg(file, otherPalette);
+    QCOMPARE(cache.missNumber(), qint64(2));
+    QCOMPARE(cache.cachedNumber(), 2);
+    QCOMPARE(otherCached.qImage().colorTable() == otherPalette.getColorTable(), true);
+
+    qInfo("Should refuse a file not in the archive");
+    QVERIFY_EXCEPTION_THROWN(cache.getImg(BsaFile(1, 2, QStringLiteral("MISSING.IMG"))), Status);
+}
+
+void DecodeCacheTest::testInvalidation() {
+    QDir looseFolder(mTemporaryDir.path());
+    QVERIFY(looseFolder.mkpath(QStringLiteral("loose")));
+    QVERIFY(looseFolder.cd(QStringLiteral("loose")));
+    writeStripesImg(looseFolder.filePath(QStringLiteral("A.IMG")), 16, 16, 50);
+    BsaArchive archive;
+    archive.openArchive(mArchivePath);
+    DecodeCache cache(archive);
+    cache.getImg(archive.getFile(QStringLiteral("A.IMG")));
+    cache.getImg(archive.getFile(QStringLiteral("B.IMG")));
+    QCOMPARE(cache.cachedNumber(), 2);
+
+    qInfo("Should drop an updated file and decode its new data without caching it");
+    archive.addOrUpdateFile(looseFolder.filePath(QStringLiteral("A.IMG")));
+    QCOMPARE(cache.cachedNumber(), 1);
+    Img updated = cache.getImg(archive.getFile(QStringLiteral("A.IMG")));
+    QCOMPARE(updated.width(), quint16(16));
+    QCOMPARE(cache.cachedNumber(), 1);
+
+    qInfo("Should drop a deleted file");
+    archive.deleteFile(archive.getFile(QStringLiteral("B.IMG")));
+    QCOMPARE(cache.cachedNumber(), 0);
+
+    qInfo("Should cache a reverted file again");
+    archive.revertChanges(archive.getFile(QStringLiteral("A.IMG")));
+    QCOMPARE(cache.getImg(archive.getFile(QStringLiteral("A.IMG"))).width(), quint16(32));
+    QCOMPARE(cache.cachedNumber(), 1);
+
+    qInfo("Should be cleared when the archive is closed");
+    archive.closeArchive();
+    QCOMPARE(cache.cachedNumber(), 0);
+    QCOMPARE(cache.usedBytes(), 0);
+}
+
+void DecodeCacheTest::testByteBudget() {
+    BsaArchive archive;
+    archive.openArchive(mArchivePath);
+    BsaFile fileA = archive.getFile(QStringLiteral("A.IMG"));
+    BsaFile fileB = archive.getFile(QStringLiteral("B.IMG"));
+
+    qInfo("Should not keep an image larger than the budget");
+    DecodeCache cache(archive, 100);
+    cache.getImg(fileA);
+    QCOMPARE(cache.cachedNumber(), 0);
+
+    qInfo("Should evict the least recently used image");
+    cache.setByteBudget(32 * 16 + 100);
+    cache.getImg(fileA);
+    cache.getImg(fileB);
+    QCOMPARE(cache.cachedNumber(), 1);
+    QCOMPARE(cache.usedBytes(), 32 * 16);
+    qint64 missNumber = cache.missNumber();
+    cache.getImg(fileB);
+    QCOMPARE(cache.missNumber(), missNumber);
+    cache.getImg(fileA);
+    QCOMPARE(cache.missNumber(), missNumber + 1);
+}
@@ -0,0 +1,51 @@
+#ifndef BSATOOL_DECODECACHETEST_H
+#define BSATOOL_DECODECACHETEST_H
+
+#include <QObject>
+#include <QTemporaryDir>
+
+class DecodeCacheTest : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief write an uncompressed IMG made of horizontal stripes
+     * @param filePath path to the file to write
+     * @param width width of the image
+     * @param height height of the image
+     * @param firstColor color of the first stripe
+     */
+    static void writeStripesImg(const QString &filePath, quint16 width, quint16 height, char firstColor);
+
+private slots:
+    /**
+     * @brief create the archive used by the tests
+     */
+    void initTestCase();
+    /**
+     * @brief test the hit and miss counting
+     */
+    void testHitsAndMisses();
+    /**
+     * @brief test the invalidation of the entries when the archive changes
+     */
+    void testInvalidation();
+    /**
+     * @brief test the eviction of the least recently used entries
+     */
+    void testByteBudget();
+
+private:
+    /**
+     * @brief folder containing the test files
+     */
+    QTemporaryDir mTemporaryDir{};
+    /**
+     * @brief path to the test archive
+     */
+    QString mArchivePath{};
+};
+
+
+#endif //BSATOOL_DECODECACHETEST_H
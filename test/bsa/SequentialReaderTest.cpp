@@ -0,0 +1,122 @@
+#include <QtTest/QtTest>
+#include <bsa/SequentialReaderTest.h>
+#include <bsa/SequentialReader.h>
+#include <bsa/BsaArchiveTest.h>
+#include <bsa/DecodeCacheTest.h>
+
+void SequentialReaderTest::initTestCase() {
+    QVERIFY(mTemporaryDir.isValid());
+    // A.DAT is first by name but written at the end of the archive
+    mArchivePath = mTemporaryDir.filePath(QStringLiteral("SCAN.BSA"));
+    BsaArchiveTest::writeSyntheticArchive(mArchivePath, 2000, 4096);
+    BsaArchiveTest::writeLooseFile(mTemporaryDir.filePath(QStringLiteral("A.DAT")), 7, 'a');
+    BsaArchive archive;
+    archive.openArchive(mArchivePath);
+    archive.addOrUpdateFile(mTemporaryDir.filePath(QStringLiteral("A.DAT")));
+    archive.saveArchiveIncrementally();
+}
+
+void SequentialReaderTest::testOffsetOrder() {
+    for (const auto openFlags : {BsaArchive::OpenFlags(BsaArchive::NO_OPEN_FLAG),
+                                 BsaArchive::OpenFlags(BsaArchive::MEMORY_MAPPED)}) {
+        BsaArchive archive;
+        archive.openArchive(mArchivePath, openFlags);
+        QCOMPARE(archive.getFiles().first().fileName(), QStringLiteral("A.DAT"));
+
+        qInfo("Should read all the files in the order of their data");
+        SequentialReader reader(archive, 4);
+        QCOMPARE(reader.files().size(), int(archive.fileNumber()));
+        QCOMPARE(reader.files().first().fileName(), QStringLiteral("F00000.DAT"));
+        QCOMPARE(reader.files().last().fileName(), QStringLiteral("A.DAT"));
+        int readNumber(0);
+        qint64 previousOffset(0);
+        while (reader.hasNext()) {
+            SequentialReader::Entry entry = reader.next();
+            QVERIFY(entry.file.startOffsetInArchive() > previousOffset);
+            previousOffset = entry.file.startOffsetInArchive();
+            QCOMPARE(entry.data == archive.getFileData(entry.file), true);
+            readNumber++;
+        }
+        QCOMPARE(readNumber, int(archive.fileNumber()));
+        QVERIFY_EXCEPTION_THROWN(reader.next(), Status);
+    }
+
+    qInfo("Should read the external files last");
+    BsaArchive archive;
+    archive.openArchive(mArchivePath);
+    BsaArchiveTest::writeLooseFile(mTemporaryDir.filePath(QStringLiteral("F00001.DAT")), 3, 'u');
+    archive.addOrUpdateFile(mTemporaryDir.filePath(QStringLiteral("F00001.DAT")));
+    SequentialReader reader(archive);
+    QCOMPARE(reader.files().last().fileName(), QStringLiteral("F00001.DAT"));
+    QCOMPARE(reader.files().at(reader.files().size() - 2).fileName(), QStringLiteral("A.DAT"));
+}
+
+void SequentialReaderTest::testDecode() {
+    DecodeCacheTest::writeStripesImg(mTemporaryDir.filePath(QStringLiteral("STRIPES.IMG")), 32, 16, 0);
+    BsaArchiveTest::writeLooseFile(mTemporaryDir.filePath(QStringLiteral("BROKEN.IMG")), 5, 'b');
+    BsaArchive archive;
+    archive.openArchive(mArchivePath);
+    archive.addOrUpdateFiles({mTemporaryDir.filePath(QStringLiteral("STRIPES.IMG")),
+                              mTemporaryDir.filePath(QStringLiteral("BROKEN.IMG"))});
+    SequentialReader reader(archive, {archive.getFile(QStringLiteral("STRIPES.IMG")),
+                                      archive.getFile(QStringLiteral("BROKEN.IMG")),
+                                      archive.getFile(QStringLiteral("F00001.DAT"))}, 2, true);
+
+    qInfo("Should give the decoded images");
+    QCOMPARE(reader.next().file.fileName(), QStringLiteral("F00001.DAT"));
+    SequentialReader::Entry entry = reader.next();
+    QCOMPARE(entry.file.fileName(), QStringLiteral("STRIPES.IMG"));
+    QCOMPARE(entry.img.width(), quint16(32));
+    QCOMPARE(entry.img.height(), quint16(16));
+    QVERIFY(!entry.img.qImage().isNull());
+
+    qInfo("Should report a file which cannot be decoded");
+    try {
+        reader.next();
+        QFAIL("The decoding should fail");
+    } catch (Status &e) {
+        QVERIFY(e.message().contains(QStringLiteral("BROKEN.IMG")));
+    }
+    QVERIFY(!reader.hasNext());
+
+    qInfo("Should give the files in reading order whatever the decoding depth");
+    SequentialReader shallowReader(archive, 4, true, Palette(), 1);
+    int readNumber(0);
+    while (shallowReader.hasNext()) {
+        const QString expectedName = shallowReader.files().at(readNumber++).fileName();
+        try {
+            QCOMPARE(shallowReader.next().file.fileName(), expectedName);
+        } catch (Status &e) {
+            QVERIFY(e.message().contains(expectedName));
+        }
+    }
+    QCOMPARE(readNumber, shallowReader.files().size());
+}
+
+void SequentialReaderTest::benchmarkSequentialScan() {
+    BsaArchive archive;
+    archive.openArchive(mArchivePath);
+    qint64 readBytes(0);
+    QBENCHMARK {
+        readBytes = 0;
+        SequentialReader reader(archive, 8);
+        while (reader.hasNext()) {
+            readBytes += reader.next().data.size();
+        }
+    }
+    QCOMPARE(readBytes, archive.size());
+}
+
+void SequentialReaderTest::benchmarkNameOrderScan() {
+    BsaArchive archive;
+    archive.openArchive(mArchivePath);
+    const QVector<BsaFile> files = archive.getFiles();
+    qint64 readBytes(0);
+    QBENCHMARK {
+        readBytes = 0;
+        for (const auto &file : files) {
+            readBytes += archive.getFileData(file).size();
+        }
+    }
+    QCOMPARE(readBytes, archive.size());
+}
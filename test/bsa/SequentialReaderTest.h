@@ -0,0 +1,45 @@
+#ifndef BSATOOL_SEQUENTIALREADERTEST_H
+#define BSATOOL_SEQUENTIALREADERTEST_H
+
+#include <QObject>
+#include <QTemporaryDir>
+
+class SequentialReaderTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    /**
+     * @brief create the archive used by the tests, whose offset order differs from its name order
+     */
+    void initTestCase();
+    /**
+     * @brief test reading all the files in offset order
+     */
+    void testOffsetOrder();
+    /**
+     * @brief test decoding the files in the background
+     */
+    void testDecode();
+    /**
+     * @brief benchmark reading all the files with the reader
+     */
+    void benchmarkSequentialScan();
+    /**
+     * @brief benchmark reading all the files in name order, for comparison
+     */
+    void benchmarkNameOrderScan();
+
+private:
+    /**
+     * @brief folder containing the test files
+     */
+    QTemporaryDir mTemporaryDir{};
+    /**
+     * @brief path to the test archive
+     */
+    QString mArchivePath{};
+};
+
+
+#endif //BSATOOL_SEQUENTIALREADERTEST_H
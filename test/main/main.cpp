@@ -1,11 +1,33 @@
 #include <QtTest/QTest>
 #include <utils/CompressionTest.h>
+#include <bsa/BsaArchiveTest.h>
+#include <bsa/ArchiveIndexTest.h>
+#include <bsa/ArchiveDiffTest.h>
+#include <bsa/BsaArchiveBuilderTest.h>
+#include <bsa/DecodeCacheTest.h>
+#include <bsa/SequentialReaderTest.h>
+#include <bsa/ArchiveVerifierTest.h>
 #include <QCoreApplication>
 
 int main(int argc, char** argv) {
     QCoreApplication app(argc, argv);
     QCoreApplication::setAttribute(Qt::AA_Use96Dpi, true);
     CompressionTest compressionTest;
+    BsaArchiveTest bsaArchiveTest;
+    ArchiveIndexTest archiveIndexTest;
+    ArchiveDiffTest archiveDiffTest;
+    BsaArchiveBuilderTest bsaArchiveBuilderTest;
+    DecodeCacheTest decodeCacheTest;
+    SequentialReaderTest sequentialReaderTest;
+    ArchiveVerifierTest archiveVerifierTest;
 
-    return QTest::qExec(&compressionTest, argc, argv);
+    int status = QTest::qExec(&compressionTest, argc, argv);
+    status |= QTest::qExec(&bsaArchiveTest, argc, argv);
+    status |= QTest::qExec(&archiveIndexTest, argc, argv);
+    status |= QTest::qExec(&archiveDiffTest, argc, argv);
+    status |= QTest::qExec(&bsaArchiveBuilderTest, argc, argv);
+    status |= QTest::qExec(&decodeCacheTest, argc, argv);
+    status |= QTest::qExec(&sequentialReaderTest, argc, argv);
+    status |= QTest::qExec(&archiveVerifierTest, argc, argv);
+    return status;
 }
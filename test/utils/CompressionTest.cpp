@@ -1,6 +1,8 @@
 #include <QtTest/QtTest>
 #include <utils/CompressionTest.h>
 #include <utils/Compression.h>
+#include <utils/HashUtils.h>
+#include <error/Status.h>
 
 void CompressionTest::testLZSSUncompression() {
     qInfo("Should uncompress the file and get the original data");
@@ -11,6 +13,12 @@ void CompressionTest::testLZSSUncompression() {
     QVector<char> uncompressedDataFromAlgorithm = Compression::uncompressLZSS(compressedDataFromFile);
     QVERIFY(!uncompressedDataFromAlgorithm.isEmpty());
     QCOMPARE(uncompressedDataFromAlgorithm == uncompressedDataFromFile, true);
+
+    qInfo("Should uncompress data much larger than its compressed version");
+    QVector<char> repeatedData(200000, 'r');
+    QVector<char> compressedRepeatedData = Compression::compressLZSS(repeatedData);
+    QVERIFY(compressedRepeatedData.size() * 3 < repeatedData.size());
+    QCOMPARE(Compression::uncompressLZSS(compressedRepeatedData) == repeatedData, true);
 }
 
 void CompressionTest::testLZSSCompression() {
@@ -48,6 +56,40 @@ void CompressionTest::testDeflateUncompressionWithReset() {
     QCOMPARE(uncompressedDataFromAlgorithm == uncompressedDataFromFile, true);
 }
 
+void CompressionTest::testTruncatedDeflateUncompression() {
+    // Hash of the data given by the decoder walking the Huffman tree bit by bit, for each truncated size. 0 if it
+    // gives more data than expected
+    const QVector<QPair<int, quint64>> truncatedResults{{10, 0x6D7C5F2C38942E88ULL}, {14, 0x72395E5FEB37A9A0ULL},
+                                                        {646, 0x74B833DA8F8F2DDEULL}, {2489, 0x31EF2CBEB082CA73ULL},
+                                                        {23829, 0}};
+    const QVector<QPair<int, quint64>> truncatedResultsWithReset{{23, 0x7A53A66E1D02B6FFULL},
+                                                                 {45, 0x99684EBE92AABCBFULL},
+                                                                 {20000, 0xAD1C49944FF04019ULL}, {50601, 0},
+                                                                 {50698, 0x69E33938E4ECF1FBULL}};
+    for (const auto &resource : {qMakePair(QStringLiteral("Deflate"), truncatedResults),
+                                 qMakePair(QStringLiteral("DeflateWorstCase"), truncatedResultsWithReset)}) {
+        QVector<char> uncompressedDataFromFile = readFile("ressources/uncompressed" + resource.first + ".data");
+        QVERIFY(!uncompressedDataFromFile.isEmpty());
+        QVector<char> compressedDataFromFile = readFile("ressources/compressed" + resource.first + ".data");
+        QVERIFY(!compressedDataFromFile.isEmpty());
+        for (const auto &truncatedResult : resource.second) {
+            QVector<char> truncatedData = compressedDataFromFile.mid(0, truncatedResult.first);
+            if (truncatedResult.second == 0) {
+                qInfo("Should refuse truncated data giving too much data");
+                QVERIFY_EXCEPTION_THROWN(Compression::uncompressDeflate(truncatedData,
+                                                                        uncompressedDataFromFile.size()), Status);
+                continue;
+            }
+            qInfo("Should uncompress truncated data like the bit by bit decoder");
+            QVector<char> uncompressedDataFromAlgorithm = Compression::uncompressDeflate(
+                    truncatedData, uncompressedDataFromFile.size());
+            QCOMPARE(uncompressedDataFromAlgorithm.size(), uncompressedDataFromFile.size());
+            QCOMPARE(HashUtils::xxHash64(uncompressedDataFromAlgorithm.constData(),
+                                         uncompressedDataFromAlgorithm.size()), truncatedResult.second);
+        }
+    }
+}
+
 void CompressionTest::testDeflateCompression() {
     qInfo("Should compress then uncompress the file and get the original data");
     QVector<char> uncompressedDataFromFile = readFile(QStringLiteral("ressources/uncompressedDeflate.data"));
@@ -115,6 +157,169 @@ void CompressionTest::testEncryptionDecryption() {
     QCOMPARE(encryptedThenDecryptedDataFromAlgorithm == decryptedDataFromFile, true);
 }
 
+void CompressionTest::testUncompressionIntoBuffer() {
+    qInfo("Should uncompress LZSS data into the buffer and give the written size");
+    QVector<char> uncompressedDataFromFile = readFile(QStringLiteral("ressources/uncompressedLZSS.data"));
+    QVERIFY(!uncompressedDataFromFile.isEmpty());
+    QVector<char> compressedDataFromFile = readFile(QStringLiteral("ressources/compressedLZSS.data"));
+    QVERIFY(!compressedDataFromFile.isEmpty());
+    QVector<char> buffer(uncompressedDataFromFile.size() + 10);
+    qint64 writtenSize = Compression::uncompressLZSS(DataView(compressedDataFromFile), buffer.data(), buffer.size());
+    QCOMPARE(writtenSize == uncompressedDataFromFile.size(), true);
+    QCOMPARE(buffer.mid(0, int(writtenSize)) == uncompressedDataFromFile, true);
+
+    qInfo("Should uncompress deflate data into the buffer");
+    uncompressedDataFromFile = readFile(QStringLiteral("ressources/uncompressedDeflate.data"));
+    QVERIFY(!uncompressedDataFromFile.isEmpty());
+    compressedDataFromFile = readFile(QStringLiteral("ressources/compressedDeflate.data"));
+    QVERIFY(!compressedDataFromFile.isEmpty());
+    buffer = QVector<char>(uncompressedDataFromFile.size());
+    Compression::uncompressDeflate(DataView(compressedDataFromFile), buffer.data(), buffer.size());
+    QCOMPARE(buffer == uncompressedDataFromFile, true);
+
+    qInfo("Should uncompress RLE by line data into the buffer");
+    uncompressedDataFromFile = readFile(QStringLiteral("ressources/uncompressedRLEByLine.data"));
+    QVERIFY(!uncompressedDataFromFile.isEmpty());
+    compressedDataFromFile = readFile(QStringLiteral("ressources/compressedRLEByLine.data"));
+    QVERIFY(!compressedDataFromFile.isEmpty());
+    buffer = QVector<char>(61 * 147);
+    Compression::uncompressRLEByLine(DataView(compressedDataFromFile), buffer.data(), 61, 147);
+    QCOMPARE(buffer == uncompressedDataFromFile, true);
+
+    qInfo("Should refuse to write past the end of the buffer");
+    compressedDataFromFile = readFile(QStringLiteral("ressources/compressedLZSS.data"));
+    buffer = QVector<char>(100);
+    QVERIFY_EXCEPTION_THROWN(Compression::uncompressLZSS(DataView(compressedDataFromFile), buffer.data(), buffer.size()),
+                             Status);
+    compressedDataFromFile = readFile(QStringLiteral("ressources/compressedRLEByLine.data"));
+    QVERIFY_EXCEPTION_THROWN(Compression::uncompressRLEByLine(DataView(compressedDataFromFile), buffer.data(), 10, 10),
+                             Status);
+}
+
+void CompressionTest::testDecode() {
+    qInfo("Should uncompress the data of each compression flag");
+    QVector<char> uncompressedDataFromFile = readFile(QStringLiteral("ressources/uncompressedRLEByLine.data"));
+    QVERIFY(!uncompressedDataFromFile.isEmpty());
+    QVector<char> buffer(61 * 147);
+    qint64 writtenSize = Compression::decode(0x02, DataView(readFile(QStringLiteral("ressources/compressedRLEByLine.data"))),
+                                             buffer.data(), 61, 147);
+    QCOMPARE(writtenSize == buffer.size(), true);
+    QCOMPARE(buffer == uncompressedDataFromFile, true);
+
+    uncompressedDataFromFile = readFile(QStringLiteral("ressources/uncompressedLZSS.data"));
+    QVERIFY(!uncompressedDataFromFile.isEmpty());
+    buffer = QVector<char>(uncompressedDataFromFile.size());
+    writtenSize = Compression::decode(0x04, DataView(readFile(QStringLiteral("ressources/compressedLZSS.data"))),
+                                      buffer.data(), buffer.size(), 1);
+    QCOMPARE(writtenSize == buffer.size(), true);
+    QCOMPARE(buffer == uncompressedDataFromFile, true);
+
+    uncompressedDataFromFile = readFile(QStringLiteral("ressources/uncompressedDeflate.data"));
+    QVERIFY(!uncompressedDataFromFile.isEmpty());
+    buffer = QVector<char>(uncompressedDataFromFile.size());
+    writtenSize = Compression::decode(0x08, DataView(readFile(QStringLiteral("ressources/compressedDeflate.data"))),
+                                      buffer.data(), buffer.size(), 1);
+    QCOMPARE(writtenSize == buffer.size(), true);
+    QCOMPARE(buffer == uncompressedDataFromFile, true);
+
+    buffer = QVector<char>(uncompressedDataFromFile.size());
+    writtenSize = Compression::decode(0x00, DataView(uncompressedDataFromFile), buffer.data(), buffer.size(), 1);
+    QCOMPARE(writtenSize == buffer.size(), true);
+    QCOMPARE(buffer == uncompressedDataFromFile, true);
+
+    qInfo("Should refuse an unknown compression flag");
+    QVERIFY_EXCEPTION_THROWN(Compression::decode(0x03, DataView(uncompressedDataFromFile), buffer.data(), 1, 1),
+                             Status);
+}
+
+void CompressionTest::benchmarkLZSSUncompression() {
+    const QVector<char> compressedDataFromFile = readFile(QStringLiteral("ressources/compressedLZSS.data"));
+    QVERIFY(!compressedDataFromFile.isEmpty());
+    QVector<char> uncompressedDataFromAlgorithm;
+    QBENCHMARK {
+        uncompressedDataFromAlgorithm = Compression::uncompressLZSS(compressedDataFromFile);
+    }
+    QCOMPARE(uncompressedDataFromAlgorithm == readFile(QStringLiteral("ressources/uncompressedLZSS.data")), true);
+}
+
+void CompressionTest::benchmarkLZSSCompression() {
+    const QVector<char> uncompressedDataFromFile = readFile(QStringLiteral("ressources/uncompressedLZSS.data"));
+    QVERIFY(!uncompressedDataFromFile.isEmpty());
+    QVector<char> compressedDataFromAlgorithm;
+    QBENCHMARK {
+        compressedDataFromAlgorithm = Compression::compressLZSS(uncompressedDataFromFile);
+    }
+    QCOMPARE(Compression::uncompressLZSS(compressedDataFromAlgorithm) == uncompressedDataFromFile, true);
+}
+
+void CompressionTest::benchmarkDeflateUncompression() {
+    const QVector<char> compressedDataFromFile = readFile(QStringLiteral("ressources/compressedDeflate.data"));
+    QVERIFY(!compressedDataFromFile.isEmpty());
+    const QVector<char> uncompressedDataFromFile = readFile(QStringLiteral("ressources/uncompressedDeflate.data"));
+    QVector<char> uncompressedDataFromAlgorithm;
+    QBENCHMARK {
+        uncompressedDataFromAlgorithm = Compression::uncompressDeflate(compressedDataFromFile,
+                                                                       uncompressedDataFromFile.size());
+    }
+    QCOMPARE(uncompressedDataFromAlgorithm == uncompressedDataFromFile, true);
+}
+
+void CompressionTest::benchmarkDeflateUncompressionWithReset() {
+    const QVector<char> compressedDataFromFile = readFile(QStringLiteral("ressources/compressedDeflateWorstCase.data"));
+    QVERIFY(!compressedDataFromFile.isEmpty());
+    const QVector<char> uncompressedDataFromFile = readFile(
+            QStringLiteral("ressources/uncompressedDeflateWorstCase.data"));
+    QVector<char> uncompressedDataFromAlgorithm;
+    QBENCHMARK {
+        uncompressedDataFromAlgorithm = Compression::uncompressDeflate(compressedDataFromFile,
+                                                                       uncompressedDataFromFile.size());
+    }
+    QCOMPARE(uncompressedDataFromAlgorithm == uncompressedDataFromFile, true);
+}
+
+void CompressionTest::benchmarkDeflateCompression() {
+    const QVector<char> uncompressedDataFromFile = readFile(QStringLiteral("ressources/uncompressedDeflate.data"));
+    QVERIFY(!uncompressedDataFromFile.isEmpty());
+    QVector<char> compressedDataFromAlgorithm;
+    QBENCHMARK {
+        compressedDataFromAlgorithm = Compression::compressDeflate(uncompressedDataFromFile);
+    }
+    QCOMPARE(Compression::uncompressDeflate(compressedDataFromAlgorithm, uncompressedDataFromFile.size()) ==
+             uncompressedDataFromFile, true);
+}
+
+void CompressionTest::benchmarkDeflateCompressionWithReset() {
+    const QVector<char> uncompressedDataFromFile = readFile(
+            QStringLiteral("ressources/uncompressedDeflateWorstCase.data"));
+    QVERIFY(!uncompressedDataFromFile.isEmpty());
+    QVector<char> compressedDataFromAlgorithm;
+    QBENCHMARK {
+        compressedDataFromAlgorithm = Compression::compressDeflate(uncompressedDataFromFile);
+    }
+    QCOMPARE(Compression::uncompressDeflate(compressedDataFromAlgorithm, uncompressedDataFromFile.size()) ==
+             uncompressedDataFromFile, true);
+}
+
+void CompressionTest::benchmarkRLEByLineUncompression() {
+    const QVector<char> compressedDataFromFile = readFile(QStringLiteral("ressources/compressedRLEByLine.data"));
+    QVERIFY(!compressedDataFromFile.isEmpty());
+    QVector<char> uncompressedDataFromAlgorithm;
+    QBENCHMARK {
+        uncompressedDataFromAlgorithm = Compression::uncompressRLEByLine(compressedDataFromFile, 61, 147);
+    }
+    QCOMPARE(uncompressedDataFromAlgorithm == readFile(QStringLiteral("ressources/uncompressedRLEByLine.data")), true);
+}
+
+void CompressionTest::benchmarkRLEByLineCompression() {
+    const QVector<char> uncompressedDataFromFile = readFile(QStringLiteral("ressources/uncompressedRLEByLine.data"));
+    QVERIFY(!uncompressedDataFromFile.isEmpty());
+    QVector<char> compressedDataFromAlgorithm;
+    QBENCHMARK {
+        compressedDataFromAlgorithm = Compression::compressRLEByLine(uncompressedDataFromFile, 61, 147);
+    }
+    QCOMPARE(Compression::uncompressRLEByLine(compressedDataFromAlgorithm, 61, 147) == uncompressedDataFromFile, true);
+}
+
 QVector<char> CompressionTest::readFile(const QString &fileName) {
     QFile file(fileName);
     file.open(QIODevice::ReadOnly);
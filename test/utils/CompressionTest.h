@@ -21,6 +21,11 @@ private slots:
      */
     static void testDeflateUncompression();
     static void testDeflateUncompressionWithReset();
+    /**
+     * @brief test deflate uncompression of truncated data against the results of the decoder walking the Huffman tree
+     * bit by bit
+     */
+    static void testTruncatedDeflateUncompression();
     /**
      * @brief test deflate compression
      */
@@ -38,6 +43,40 @@ private slots:
      * @brief test encryption decryption
      */
     static void testEncryptionDecryption();
+    /**
+     * @brief test uncompression into a buffer given by the caller
+     */
+    static void testUncompressionIntoBuffer();
+    /**
+     * @brief test uncompression according to an image compression flag
+     */
+    static void testDecode();
+    /**
+     * @brief measure LZSS uncompression
+     */
+    static void benchmarkLZSSUncompression();
+    /**
+     * @brief measure LZSS compression
+     */
+    static void benchmarkLZSSCompression();
+    /**
+     * @brief measure deflate uncompression
+     */
+    static void benchmarkDeflateUncompression();
+    static void benchmarkDeflateUncompressionWithReset();
+    /**
+     * @brief measure deflate compression
+     */
+    static void benchmarkDeflateCompression();
+    static void benchmarkDeflateCompressionWithReset();
+    /**
+     * @brief measure RLE by line uncompression
+     */
+    static void benchmarkRLEByLineUncompression();
+    /**
+     * @brief measure RLE by line compression
+     */
+    static void benchmarkRLEByLineCompression();
 
 public:
     [[nodiscard]] static QVector<char> readFile(const QString &fileName) ;